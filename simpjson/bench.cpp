@@ -0,0 +1,269 @@
+﻿#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+#include <random>
+
+#include "sjson.hpp"
+
+/*
+* 性能测试：bench [名称...]，不带参数时运行全部。
+* 每项重复若干轮，输出最快一轮的时间；输入由固定的随机种子生成，结果可以复现
+*/
+
+using namespace sjson;
+
+/*
+* 统计堆上当前分配的字节数：替换全局的 operator new/delete，
+* 每块前面多分配 16 字节记录大小（保持 max_align_t 的对齐）
+*/
+static std::atomic<size_t> heap_bytes{ 0 };
+
+void* operator new(size_t n)
+{
+	void* p = std::malloc(n + 16);
+	if (!p)throw std::bad_alloc();
+	*static_cast<size_t*>(p) = n;
+	heap_bytes.fetch_add(n, std::memory_order_relaxed);
+	return static_cast<char*>(p) + 16;
+}
+void operator delete(void* p) noexcept
+{
+	if (!p)return;
+	void* block = static_cast<char*>(p) - 16;
+	heap_bytes.fetch_sub(*static_cast<size_t*>(block), std::memory_order_relaxed);
+	std::free(block);
+}
+void operator delete(void* p, size_t) noexcept
+{
+	operator delete(p);
+}
+
+namespace
+{
+	using bench_clock = std::chrono::steady_clock;
+
+	// 运行 f rounds 次，返回最快一次的毫秒数
+	template<typename _func_t>
+	double best_ms(int rounds, _func_t&& f)
+	{
+		double best = 1e300;
+		for (int i = 0; i < rounds; ++i)
+		{
+			auto t0 = bench_clock::now();
+			f();
+			auto t1 = bench_clock::now();
+			best = std::min(best, std::chrono::duration<double, std::milli>(t1 - t0).count());
+		}
+		return best;
+	}
+
+	// 防止结果被优化掉
+	volatile size_t sink = 0;
+
+	// n 条记录组成的数组，每条含数字、字符串、布尔、嵌套对象与数组
+	json make_records(size_t n)
+	{
+		std::mt19937 rng(12345);
+		json arr(json_value_t::array);
+		for (size_t i = 0; i < n; ++i)
+		{
+			json rec = {
+				{"id", static_cast<int>(i)},
+				{"name", "user " + std::to_string(rng() % 100000)},
+				{"score", (rng() % 10000) / 100.0},
+				{"active", rng() % 2 == 0},
+				{"tags", {"alpha", "beta", "gamma"}},
+				{"address", {{"city", "city " + std::to_string(rng() % 100)}, {"zip", static_cast<int>(rng() % 100000)}}}
+			};
+			arr.push_back(std::move(rec));
+		}
+		return arr;
+	}
+
+	template<typename _json_t = json>
+	_json_t parse_text(const std::string& s)
+	{
+		_sjson_detail::parser<_json_t> p{ std::string_view(s) };
+		return std::move(p).result();
+	}
+
+	// 只统计事件数量的 SAX 处理器
+	struct count_handler
+	{
+		size_t events = 0, bytes = 0;
+		bool start_object() { ++events; return true; }
+		bool end_object() { ++events; return true; }
+		bool start_array() { ++events; return true; }
+		bool end_array() { ++events; return true; }
+		bool key(std::string_view k) { ++events; bytes += k.size(); return true; }
+		bool string(std::string_view s) { ++events; bytes += s.size(); return true; }
+		bool number_int64(int64_t) { ++events; return true; }
+		bool number_uint64(uint64_t) { ++events; return true; }
+		bool number_double(double) { ++events; return true; }
+		bool boolean(bool) { ++events; return true; }
+		bool null() { ++events; return true; }
+	};
+
+	void bench_sax()
+	{
+		std::string s = make_records(50000).dump(0);
+		double dom = best_ms(9, [&] { sink = sink + parse_text(s).size(); });
+		double sax = best_ms(9, [&]
+			{
+				count_handler h;
+				sax_parse(s, h);
+				sink = sink + h.events;
+			});
+		std::printf("  %6.1f MiB  DOM %7.1f ms  SAX %7.1f ms\n", s.size() / 1048576.0, dom, sax);
+	}
+
+	// 解析 s 得到的值所占的堆内存（MiB）与最快一轮的解析时间
+	template<typename _func_t>
+	void report_memory(const char* name, const std::string& s, _func_t&& parse)
+	{
+		double mib = 0;
+		{
+			size_t before = heap_bytes.load();
+			auto v = parse(s);
+			mib = (heap_bytes.load() - before) / 1048576.0;
+			sink = sink + v.size();
+		}
+		double ms = best_ms(9, [&] { sink = sink + parse(s).size(); });
+		std::printf("    %-12s %8.1f MiB  parse %7.1f ms\n", name, mib, ms);
+	}
+
+	void bench_compact()
+	{
+		std::mt19937 rng(12345);
+		std::string numbers = "[";
+		for (int i = 0; i < 1000000; ++i)
+			numbers += (i ? "," : "") + std::to_string(rng() % 2 ? int(rng() % 100000) : -int(rng() % 1000));
+		numbers += "]";
+		std::string records = make_records(50000).dump(0);
+
+		for (auto* s : { &numbers, &records })
+		{
+			std::printf("  %s (%.1f MiB of text)\n", s == &numbers ? "1M integers" : "50k records", s->size() / 1048576.0);
+			report_memory("json", *s, [](const std::string& x) { return parse_text(x); });
+			report_memory("compact_json", *s, [](const std::string& x) { return parse_compact(x); });
+		}
+	}
+
+	// n 个对象组成的数组，每个对象有 keys 个键 "field_0" ~ "field_<keys-1>"
+	std::string make_objects(size_t n, size_t keys)
+	{
+		std::mt19937 rng(12345);
+		std::string s = "[";
+		for (size_t i = 0; i < n; ++i)
+		{
+			s += i ? ",{" : "{";
+			for (size_t k = 0; k < keys; ++k)
+				s += (k ? ",\"field_" : "\"field_") + std::to_string(k) + "\":" + std::to_string(rng() % 1000);
+			s += "}";
+		}
+		return s + "]";
+	}
+
+	// 解析、每个对象查找 3 个键（重复 10 遍）与 dump 的时间
+	template<typename _json_t>
+	void report_objects(const char* name, const std::string& s, size_t keys)
+	{
+		const std::string wanted[] = { "field_0", "field_" + std::to_string(keys / 2), "field_" + std::to_string(keys - 1) };
+		_json_t doc = parse_text<_json_t>(s);
+		double parse = best_ms(5, [&] { sink = sink + parse_text<_json_t>(s).size(); });
+		const _json_t& cdoc = doc;
+		double lookup = best_ms(5, [&]
+			{
+				for (int r = 0; r < 10; ++r)
+				{
+					for (size_t i = 0, n = doc.size(); i < n; ++i)
+					{
+						for (const auto& k : wanted)sink = sink + static_cast<size_t>(cdoc[i][k].type());
+					}
+				}
+			});
+		double dump = best_ms(5, [&] { sink = sink + doc.dump(0).size(); });
+		std::printf("    %-14s parse %7.1f ms  lookup %7.1f ms  dump %7.1f ms\n", name, parse, lookup, dump);
+	}
+
+	void bench_flat()
+	{
+		for (size_t keys : { 4, 12, 40 })
+		{
+			std::string s = make_objects(400000 / keys, keys);
+			std::printf("  %zu keys per object (%.1f MiB)\n", keys, s.size() / 1048576.0);
+			report_objects<json>("unordered_map", s, keys);
+			report_objects<flat_json>("flat_map", s, keys);
+		}
+	}
+
+	// 在 _map_t 中插入全部 keys，再按打乱的顺序查找全部 keys 与同样数量的不存在的键
+	template<typename _map_t>
+	void report_map(const char* name, const std::vector<std::string>& keys,
+		const std::vector<std::string>& hits, const std::vector<std::string>& misses)
+	{
+		int rounds = keys.size() >= 1000000 ? 3 : 7;
+		double insert = best_ms(rounds, [&]
+			{
+				_map_t m;
+				for (const auto& k : keys)m[k] = 1;
+				sink = sink + m.size();
+			});
+		_map_t m;
+		for (const auto& k : keys)m[k] = 1;
+		double hit = best_ms(rounds, [&] { for (const auto& k : hits)sink = sink + (m.find(k) != m.end()); });
+		double miss = best_ms(rounds, [&] { for (const auto& k : misses)sink = sink + (m.find(k) != m.end()); });
+		std::printf("    %-14s insert %8.1f ms  hit %7.1f ms  miss %7.1f ms\n", name, insert, hit, miss);
+	}
+
+	void bench_swiss()
+	{
+		for (size_t n : { 10000, 100000, 1000000 })
+		{
+			std::mt19937 rng(12345);
+			std::vector<std::string> keys, misses;
+			for (size_t i = 0; i < n; ++i)
+			{
+				keys.push_back("id_" + std::to_string(i * 2) + "_" + std::to_string(rng() % 1000));
+				misses.push_back("id_" + std::to_string(i * 2 + 1) + "_x");
+			}
+			std::vector<std::string> hits = keys;
+			std::shuffle(hits.begin(), hits.end(), rng);
+			std::printf("  %zu keys\n", n);
+			report_map<json::object_t>("unordered_map", keys, hits, misses);
+			report_map<swiss_json::object_t>("swiss_map", keys, hits, misses);
+		}
+	}
+
+	struct bench_entry
+	{
+		const char* name;
+		const char* desc;
+		void (*run)();
+	};
+	const bench_entry benches[] = {
+		{ "sax", "SAX events against building the DOM", bench_sax },
+		{ "compact", "memory and parse time of json against compact_json", bench_compact },
+		{ "flat", "objects with a few keys in flat_map against std::unordered_map", bench_flat },
+		{ "swiss", "insert and lookup in large objects, swiss_map against std::unordered_map", bench_swiss },
+	};
+}
+
+int main(int argc, char** argv)
+{
+	for (const auto& b : benches)
+	{
+		bool selected = argc == 1;
+		for (int i = 1; i < argc; ++i)selected |= std::strcmp(argv[i], b.name) == 0;
+		if (!selected)continue;
+		std::printf("%s: %s\n", b.name, b.desc);
+		b.run();
+	}
+	return 0;
+}
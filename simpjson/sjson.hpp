@@ -1,10 +1,17 @@
 ﻿#include <variant>
 #include <vector>
 #include <string>
+#include <string_view>
 #include <map>
 #include <unordered_map>
+#include <unordered_set>
+#include <tuple>
+#include <optional>
+#include <memory_resource>
 
 #include <utility> // std::move
+#include <iterator> // std::contiguous_iterator
+#include <memory> // std::to_address
 
 #include <exception>
 
@@ -12,8 +19,64 @@
 
 #include <iomanip> // setw
 
+#include <algorithm> // std::min
+
 #include <functional>
 
+#include <bit> // std::countr_zero
+#include <cstring> // std::memcpy
+#include <charconv> // std::from_chars
+#include <limits>
+#include <cmath> // std::isfinite
+#include <thread>
+#include <atomic>
+#include <random> // std::random_device
+
+/*
+* 定义 _SJSON_DISABLE_SIMD 以禁用 SIMD 指令（全部使用标量实现）
+*/
+//#define _SJSON_DISABLE_SIMD
+
+#if !defined(_SJSON_DISABLE_SIMD)
+#if defined(__AVX2__)
+#define _SJSON_SIMD_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define _SJSON_SIMD_SSE2
+#include <emmintrin.h>
+#endif
+#endif
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h> // _umul128
+#endif
+
+/*
+* 定义 _SJSON_DISABLE_MMAP 以禁用文件映射（mapped_file 改为把整个文件读入内存）
+*/
+//#define _SJSON_DISABLE_MMAP
+
+/*
+* 定义 _SJSON_HASH_SEED 为一个整数以固定 swiss_map 的哈希种子（默认每个进程随机选取，见 _sjson_detail::hash_seed）。
+* swiss_json 中对象的遍历与 dump 的键顺序取决于种子，需要在各次运行之间得到相同的输出时定义它
+*/
+//#define _SJSON_HASH_SEED 0
+
+#if !defined(_SJSON_DISABLE_MMAP)
+#if defined(_WIN32)
+// 不改变 windows.h 的配置宏：它有 include 保护，这里的配置会影响用户之后引入的 windows.h
+// min 宏不影响本文件（调用处都加了括号），max 宏在下面取消定义
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#else
+#include <fstream>
+#endif
+
 #undef max
 
 namespace sjson {
@@ -117,7 +180,7 @@ namespace _sjson_detail
 		}
 	};
 
-	void escape_to_ascii(const std::string& s, std::string& out)
+	void escape_to_ascii(std::string_view s, std::string& out)
 	{
 		std::stringstream ss;
 		ss << std::hex;
@@ -161,131 +224,865 @@ namespace _sjson_detail
 		out += ss.str();
 	}
 
-	enum class parser_delimiter :uint32_t
+	void dump_double_to(double d, std::string& out)
 	{
-		comma = ',',
-		colon = ':',
-		left_bracket = '[',
-		right_bracket = ']',
-		left_brace = '{',
-		right_brace = '}'
-	};
+		std::stringstream ss;
+		ss << std::defaultfloat << d;
+		std::string s = ss.str();
+		s.erase(std::remove(s.begin(), s.end(), '+'), s.end());
+		out += s;
+	}
 
-	template<typename _json_t>
-	class parser;
+	/**
+	 * \brief 将合法的数字原文 [beg, end) 转换为 _t
+	 * \return 是否成功：整数类型要求原文为整数且在 _t 的范围内；double 溢出时为 ±inf，下溢时为 ±0
+	 */
+	template<typename _t, typename _char_t>
+	bool number_from_text(const _char_t* beg, const _char_t* end, _t& out)
+	{
+		std::string narrow;
+		const char* p;
+		const char* e;
+		if constexpr (sizeof(_char_t) == 1)
+		{
+			p = reinterpret_cast<const char*>(beg);
+			e = reinterpret_cast<const char*>(end);
+		}
+		else
+		{
+			narrow.assign(beg, end);
+			p = narrow.data();
+			e = p + narrow.size();
+		}
+		if (p != e && *p == '+')++p; // from_chars 不接受 '+'
+		std::from_chars_result r;
+		if constexpr (std::is_floating_point_v<_t>)
+		{
+			r = std::from_chars(p, e, out, std::chars_format::general);
+			if (r.ec == std::errc::result_out_of_range)
+			{
+				const char* x = std::find_if(p, e, [](char ch) { return ch == 'e' || ch == 'E'; });
+				bool tiny = x != e
+					? (x + 1 != e && x[1] == '-')
+					: std::all_of(p, std::find(p, e, '.'), [](char ch) { return ch == '0' || ch == '-'; });
+				out = tiny ? _t(0) : std::numeric_limits<_t>::infinity();
+				if (*p == '-')out = -out;
+				return true;
+			}
+		}
+		else r = std::from_chars(p, e, out);
+		return r.ec == std::errc() && r.ptr == e;
+	}
 
-};
+	/**
+	 * \brief 将原样保存的数字 r 转换为 _t，不修改 r（同一个数字可以在多个线程中同时读取）
+	 * \return 能否转换（见 number_from_text），不能时 out 保持不变
+	 */
+	template<typename _t, typename _raw_t>
+	bool raw_number_get(const _raw_t& r, _t& out)
+	{
+		const auto* p = r.text.data();
+		const auto* end = p + r.text.size();
+		if constexpr (std::is_integral_v<_t>)
+		{
+			if (r.fits_int64)
+			{
+				// 不超过 18 位的整数不会溢出 int64_t，直接逐位累加
+				bool neg = *p == '-';
+				if (neg || *p == '+')++p;
+				int64_t v = 0;
+				for (; p != end; ++p)v = v * 10 + (*p - '0');
+				if (neg)v = -v;
+				if (!std::in_range<_t>(v))return false;
+				out = static_cast<_t>(v);
+				return true;
+			}
+		}
+		return number_from_text(p, end, out);
+	}
 
-enum class json_value_t
-{
-	array,
-	object,
+	/**
+	 * \brief 按 static_cast 的规则将原样保存的数字 r 转换为任意数值类型 _t（整数原文转换为整数时不经过 double）
+	 */
+	template<typename _t, typename _raw_t>
+	_t raw_number_cast(const _raw_t& r)
+	{
+		if constexpr (std::is_integral_v<_t>)
+		{
+			if (r.integral)
+			{
+				int64_t i;
+				if (raw_number_get(r, i))return static_cast<_t>(i);
+				uint64_t u;
+				if (!r.fits_int64 && raw_number_get(r, u))return static_cast<_t>(u);
+			}
+		}
+		double d;
+		return raw_number_get(r, d) ? static_cast<_t>(d) : _t();
+	}
 
-	null,
-	num_double,
-	num_i32,
-	boolean,
-	string,
+	/**
+	 * \brief 把数字 v 转换为数值类型 _t，只接受有定义且不改变整数值的转换：
+	 *        转为整数（包括 bool）时 v 必须是该类型范围内的整数，转为更窄的浮点类型时不能溢出（允许舍入）
+	 * \return 能否转换，不能时 out 保持不变
+	 */
+	template<typename _t, typename _src_t>
+	bool number_convert(_src_t v, _t& out)
+	{
+		if constexpr (std::is_same_v<_t, bool>)
+		{
+			if (v != _src_t(0) && v != _src_t(1))return false;
+			out = v == _src_t(1);
+		}
+		else if constexpr (std::is_integral_v<_t>)
+		{
+			if constexpr (std::is_integral_v<_src_t>)
+			{
+				if (!std::in_range<_t>(v))return false;
+			}
+			else
+			{
+				// [min, 2^digits) 在 double 中可以精确表示，NaN 不满足任何比较
+				constexpr double lo = static_cast<double>((std::numeric_limits<_t>::min)());
+				constexpr double hi = 2.0 * static_cast<double>(uint64_t(1) << (std::numeric_limits<_t>::digits - 1));
+				if (!(lo <= v && v < hi) || std::trunc(v) != v)return false;
+			}
+			out = static_cast<_t>(v);
+		}
+		else
+		{
+			if constexpr (std::is_floating_point_v<_src_t> && sizeof(_t) < sizeof(_src_t))
+			{
+				if (std::isfinite(v) && std::abs(v) > std::numeric_limits<_t>::max())return false;
+			}
+			out = static_cast<_t>(v);
+		}
+		return true;
+	}
 
-	num_ui32, num_i64, num_ui64
-};
+	/**
+	 * \brief 按 number_convert 的规则将原样保存的数字 r 转换为 _t（整数原文转换为整数时不经过 double）
+	 */
+	template<typename _t, typename _raw_t>
+	bool raw_number_to(const _raw_t& r, _t& out)
+	{
+		if constexpr (std::is_integral_v<_t>)
+		{
+			if (r.integral)
+			{
+				int64_t i;
+				if (raw_number_get(r, i))return number_convert(i, out);
+				uint64_t u;
+				if (!r.fits_int64 && raw_number_get(r, u))return number_convert(u, out);
+			}
+		}
+		double d;
+		return raw_number_get(r, d) && number_convert(d, out);
+	}
 
-constexpr inline const char* json_type_name(json_value_t x)
-{
-	return x == json_value_t::array
-		? "array"
-		: (x == json_value_t::object ? "object" : "value");
-}
-constexpr const char* json_value_t_name(json_value_t x)
-{
-	constexpr const char* name_of[] =
+	namespace simd
 	{
-		"array", "object",
-		
-		"null",
+		/*
+		* 64 字节块的字符分类掩码，第 i 位对应块中第 i 个字节
+		* space 与 parser 的空白一致：' ' 与 '\t' ~ '\r'
+		*/
+		struct block_masks
+		{
+			uint64_t quote = 0, backslash = 0, slash = 0, space = 0, op = 0;
+		};
 
-		"num.double", "num.int32", "num.boolean",
-		"string",
+#if defined(_SJSON_SIMD_AVX2)
 
-		"num.uint32","num.int64","num.uint64",
+		inline block_masks classify_block(const char* p)
+		{
+			block_masks res;
+			for (int i = 0; i < 64; i += 32)
+			{
+				__m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+				auto eq = [](__m256i v, char c)
+				{
+					return _mm256_cmpeq_epi8(v, _mm256_set1_epi8(c));
+				};
+				auto bits = [](__m256i v)
+				{
+					return static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(v)));
+				};
+				// '[' ']' 与 '{' '}' 只差 0x20 这一位
+				__m256i lower = _mm256_or_si256(x, _mm256_set1_epi8(0x20));
+				__m256i op = _mm256_or_si256(
+					_mm256_or_si256(eq(lower, '{'), eq(lower, '}')),
+					_mm256_or_si256(eq(x, ':'), eq(x, ','))
+				);
+				__m256i t = _mm256_sub_epi8(x, _mm256_set1_epi8('\t'));
+				__m256i space = _mm256_or_si256(
+					eq(x, ' '),
+					_mm256_cmpeq_epi8(_mm256_min_epu8(t, _mm256_set1_epi8('\r' - '\t')), t)
+				);
+				res.quote |= bits(eq(x, '"')) << i;
+				res.backslash |= bits(eq(x, '\\')) << i;
+				res.slash |= bits(eq(x, '/')) << i;
+				res.space |= bits(space) << i;
+				res.op |= bits(op) << i;
+			}
+			return res;
+		}
 
-		"parser.delimiter"
-	};
+#elif defined(_SJSON_SIMD_SSE2)
 
-	return static_cast<size_t>(x) < 11
-		? name_of[static_cast<size_t>(x)]
-		: "unknown";
-}
+		inline block_masks classify_block(const char* p)
+		{
+			block_masks res;
+			for (int i = 0; i < 64; i += 16)
+			{
+				__m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+				auto eq = [](__m128i v, char c)
+				{
+					return _mm_cmpeq_epi8(v, _mm_set1_epi8(c));
+				};
+				auto bits = [](__m128i v)
+				{
+					return static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(v)));
+				};
+				// '[' ']' 与 '{' '}' 只差 0x20 这一位
+				__m128i lower = _mm_or_si128(x, _mm_set1_epi8(0x20));
+				__m128i op = _mm_or_si128(
+					_mm_or_si128(eq(lower, '{'), eq(lower, '}')),
+					_mm_or_si128(eq(x, ':'), eq(x, ','))
+				);
+				__m128i t = _mm_sub_epi8(x, _mm_set1_epi8('\t'));
+				__m128i space = _mm_or_si128(
+					eq(x, ' '),
+					_mm_cmpeq_epi8(_mm_min_epu8(t, _mm_set1_epi8('\r' - '\t')), t)
+				);
+				res.quote |= bits(eq(x, '"')) << i;
+				res.backslash |= bits(eq(x, '\\')) << i;
+				res.slash |= bits(eq(x, '/')) << i;
+				res.space |= bits(space) << i;
+				res.op |= bits(op) << i;
+			}
+			return res;
+		}
 
-enum class json_parse_error
-{
-	item_not_closed, // <注释/字符串/数组/对象> 未闭合，具体取决于 origin
-	illegal_escape, // 不符合规定的 <unicode/\xxx> 转义序列
-	invalid_unicode_code, // 无效的 unicode 码
-	unknown_keyword, // 未知的的关键词
-	/*
-	* msg 格式:
-	*   xxxxx@yyyyyy
-	* 以第一个 '@' 为分隔符
-	* 前面是期望值(<值类型> 或 {正则表达式}) 后面是实际值
-	*/
-	unexpected_item, // 意外的值/对象/字符
-};
+#else
 
-enum class json_callback_ret
-{
-	ignore_and_continue,
-	abort
-};
-enum class json_error_origin
-{
-	parse_comment,
-	parse_string,
-	parse_unicode,
-	parse_keyword,
-	parse_delimiter,
-	parse_array,
-	parse_object
-};
+		inline block_masks classify_block(const char* p)
+		{
+			block_masks res;
+			for (int i = 0; i < 64; ++i)
+			{
+				uint64_t bit = uint64_t(1) << i;
+				switch (p[i])
+				{
+				case '"': res.quote |= bit; break;
+				case '\\': res.backslash |= bit; break;
+				case '/': res.slash |= bit; break;
+				case ' ': case '\t': case '\n': case '\v': case '\f': case '\r':
+					res.space |= bit; break;
+				case '{': case '}': case '[': case ']': case ':': case ',':
+					res.op |= bit; break;
+				default:
+					break;
+				}
+			}
+			return res;
+		}
 
-using json_parse_error_callback_f = std::function<
-	json_callback_ret(
-		uint32_t line, uint32_t column,
-		json_error_origin origin,
-		json_parse_error e, const std::string& msg
-		)
->;
+#endif
 
-namespace _sjson_detail
-{
-	json_callback_ret defult_parse_err_callback(
-		uint32_t line, uint32_t column,
-		json_error_origin origin,
-		json_parse_error e, const std::string& msg
-	);
-}
+		/**
+		 * \return [p, end) 中第一个 '"'、'\\' 或 '\0' 的位置，没有则返回 end
+		 */
+		inline const char* find_string_special(const char* p, const char* end)
+		{
+#if defined(_SJSON_SIMD_AVX2)
+			{
+				const __m256i quote = _mm256_set1_epi8('"');
+				const __m256i bs = _mm256_set1_epi8('\\');
+				const __m256i zero = _mm256_setzero_si256();
+				for (; end - p >= 32; p += 32)
+				{
+					__m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+					__m256i hit = _mm256_or_si256(
+						_mm256_or_si256(_mm256_cmpeq_epi8(x, quote), _mm256_cmpeq_epi8(x, bs)),
+						_mm256_cmpeq_epi8(x, zero)
+					);
+					auto m = static_cast<uint32_t>(_mm256_movemask_epi8(hit));
+					if (m)return p + std::countr_zero(m);
+				}
+			}
+#endif
+#if defined(_SJSON_SIMD_AVX2) || defined(_SJSON_SIMD_SSE2)
+			{
+				const __m128i quote = _mm_set1_epi8('"');
+				const __m128i bs = _mm_set1_epi8('\\');
+				const __m128i zero = _mm_setzero_si128();
+				for (; end - p >= 16; p += 16)
+				{
+					__m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+					__m128i hit = _mm_or_si128(
+						_mm_or_si128(_mm_cmpeq_epi8(x, quote), _mm_cmpeq_epi8(x, bs)),
+						_mm_cmpeq_epi8(x, zero)
+					);
+					auto m = static_cast<uint32_t>(_mm_movemask_epi8(hit));
+					if (m)return p + std::countr_zero(m);
+				}
+			}
+#endif
+			for (; p != end; ++p)
+			{
+				if (*p == '"' || *p == '\\' || *p == '\0')break;
+			}
+			return p;
+		}
 
-/*
-* ecode:
-* 0 try failed
-* 1 bad call: call xxx method on yyy
-*/
+		/**
+		 * \return [p, end) 中第一个非空白字符的位置，没有则返回 end
+		 */
+		inline const char* skip_space(const char* p, const char* end)
+		{
+#if defined(_SJSON_SIMD_AVX2)
+			{
+				const __m256i sp = _mm256_set1_epi8(' ');
+				const __m256i tab = _mm256_set1_epi8('\t');
+				const __m256i range = _mm256_set1_epi8('\r' - '\t');
+				for (; end - p >= 32; p += 32)
+				{
+					__m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+					__m256i t = _mm256_sub_epi8(x, tab);
+					__m256i space = _mm256_or_si256(
+						_mm256_cmpeq_epi8(x, sp),
+						_mm256_cmpeq_epi8(_mm256_min_epu8(t, range), t)
+					);
+					auto m = ~static_cast<uint32_t>(_mm256_movemask_epi8(space));
+					if (m)return p + std::countr_zero(m);
+				}
+			}
+#endif
+#if defined(_SJSON_SIMD_AVX2) || defined(_SJSON_SIMD_SSE2)
+			{
+				const __m128i sp = _mm_set1_epi8(' ');
+				const __m128i tab = _mm_set1_epi8('\t');
+				const __m128i range = _mm_set1_epi8('\r' - '\t');
+				for (; end - p >= 16; p += 16)
+				{
+					__m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+					__m128i t = _mm_sub_epi8(x, tab);
+					__m128i space = _mm_or_si128(
+						_mm_cmpeq_epi8(x, sp),
+						_mm_cmpeq_epi8(_mm_min_epu8(t, range), t)
+					);
+					auto m = ~static_cast<uint32_t>(_mm_movemask_epi8(space)) & 0xffffu;
+					if (m)return p + std::countr_zero(m);
+				}
+			}
+#endif
+			for (; p != end; ++p)
+			{
+				if (*p != ' ' && (*p < '\t' || *p > '\r'))break;
+			}
+			return p;
+		}
 
-class json_error :public std::exception
-{
-public:
-	
-	json_error(const char* s, int ec) :_what(s), _err_code(ec) {}
-	json_error(const std::string& s, int ec = 0) :_what(s), _err_code(ec) {}
-	json_error(int line, const char* func, const std::string& str, int ec)
-		: _what(std::string("sjson.hpp:") + std::to_string(line) +
-			':' + func + (ec ? ":[json_error." + std::to_string(ec) + "] " : ": ")  + str), _err_code(ec) {}
+		/**
+		 * \return p[0, 16) 中等于 b 的字节的掩码，第 i 位对应 p[i]
+		 */
+		inline uint32_t match_byte16(const uint8_t* p, uint8_t b)
+		{
+#if defined(_SJSON_SIMD_AVX2) || defined(_SJSON_SIMD_SSE2)
+			__m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+			return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(x, _mm_set1_epi8(static_cast<char>(b)))));
+#else
+			uint32_t m = 0;
+			for (int i = 0; i < 16; ++i)m |= static_cast<uint32_t>(p[i] == b) << i;
+			return m;
+#endif
+		}
 
-	int error_code()const { return _err_code; }
+		/**
+		 * \return p[0, 16) 中最高位为 1 的字节的掩码，第 i 位对应 p[i]
+		 */
+		inline uint32_t match_high16(const uint8_t* p)
+		{
+#if defined(_SJSON_SIMD_AVX2) || defined(_SJSON_SIMD_SSE2)
+			return static_cast<uint32_t>(_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))));
+#else
+			uint32_t m = 0;
+			for (int i = 0; i < 16; ++i)m |= static_cast<uint32_t>(p[i] >> 7) << i;
+			return m;
+#endif
+		}
 
-	virtual const char* what()const
-	{
-		return _what.c_str();
+		/**
+		 * \param x 掩码
+		 * \return 第 i 位为 x 的第 0~i 位的异或
+		 */
+		constexpr uint64_t prefix_xor(uint64_t x)
+		{
+			x ^= x << 1;
+			x ^= x << 2;
+			x ^= x << 4;
+			x ^= x << 8;
+			x ^= x << 16;
+			x ^= x << 32;
+			return x;
+		}
+
+		/**
+		 * \return p 处一个完整 UTF-8 序列的字节数，不合法（截断、过长编码、代理项、超出 U+10FFFF）返回 0
+		 */
+		inline int utf8_seq_len(const char* p, const char* end)
+		{
+			auto b = static_cast<uint8_t>(*p);
+			if (b < 0x80)return 1;
+			int n;
+			uint8_t lo = 0x80, hi = 0xbf;
+			if (b >= 0xc2 && b <= 0xdf)n = 2;
+			else if (b >= 0xe0 && b <= 0xef)
+			{
+				n = 3;
+				if (b == 0xe0)lo = 0xa0;
+				else if (b == 0xed)hi = 0x9f;
+			}
+			else if (b >= 0xf0 && b <= 0xf4)
+			{
+				n = 4;
+				if (b == 0xf0)lo = 0x90;
+				else if (b == 0xf4)hi = 0x8f;
+			}
+			else return 0;
+			if (end - p < n)return 0;
+			auto c = static_cast<uint8_t>(p[1]);
+			if (c < lo || c > hi)return 0;
+			for (int i = 2; i < n; ++i)
+			{
+				if ((static_cast<uint8_t>(p[i]) & 0xc0) != 0x80)return 0;
+			}
+			return n;
+		}
+
+		/**
+		 * \brief 逐字符校验 [p, end)，p 须位于字符边界
+		 * \return 第一个不合法序列的开头，全部合法返回 end
+		 */
+		inline const char* validate_utf8_scalar(const char* p, const char* end)
+		{
+			while (p != end)
+			{
+				if (static_cast<uint8_t>(*p) < 0x80)
+				{
+					++p;
+					continue;
+				}
+				int n = utf8_seq_len(p, end);
+				if (!n)return p;
+				p += n;
+			}
+			return p;
+		}
+
+#if defined(_SJSON_SIMD_AVX2)
+		/**
+		 * \brief Keiser–Lemire 查表法所用的三张 16 项表（按前一字节高 4 位、低 4 位和当前字节高 4 位索引），
+		 *        三者按位与后非 0 即有错误；多字节序列的长度另由 prev2/prev3 检查
+		 */
+		struct utf8_tables
+		{
+			static constexpr uint8_t too_short = 1 << 0, too_long = 1 << 1, overlong_3 = 1 << 2,
+				too_large = 1 << 3, surrogate = 1 << 4, overlong_2 = 1 << 5,
+				too_large_1000 = 1 << 6, overlong_4 = 1 << 6, two_conts = 1 << 7,
+				carry = too_short | too_long | two_conts;
+
+			__m256i byte_1_high, byte_1_low, byte_2_high, nibble, incomplete;
+
+			utf8_tables()
+			{
+				byte_1_high = _mm256_setr_epi8(
+					too_long, too_long, too_long, too_long, too_long, too_long, too_long, too_long,
+					two_conts, two_conts, two_conts, two_conts,
+					too_short | overlong_2, too_short, too_short | overlong_3 | surrogate,
+					too_short | too_large | too_large_1000 | overlong_4,
+					too_long, too_long, too_long, too_long, too_long, too_long, too_long, too_long,
+					two_conts, two_conts, two_conts, two_conts,
+					too_short | overlong_2, too_short, too_short | overlong_3 | surrogate,
+					too_short | too_large | too_large_1000 | overlong_4
+				);
+				constexpr char big = carry | too_large | too_large_1000;
+				byte_1_low = _mm256_setr_epi8(
+					carry | overlong_3 | overlong_2 | overlong_4, carry | overlong_2, carry, carry,
+					carry | too_large, big, big, big, big, big, big, big, big, big | surrogate, big, big,
+					carry | overlong_3 | overlong_2 | overlong_4, carry | overlong_2, carry, carry,
+					carry | too_large, big, big, big, big, big, big, big, big, big | surrogate, big, big
+				);
+				constexpr char c80 = too_long | overlong_2 | two_conts | overlong_3 | too_large_1000 | overlong_4;
+				constexpr char c90 = too_long | overlong_2 | two_conts | overlong_3 | too_large;
+				constexpr char ca0 = too_long | overlong_2 | two_conts | surrogate | too_large;
+				byte_2_high = _mm256_setr_epi8(
+					too_short, too_short, too_short, too_short, too_short, too_short, too_short, too_short,
+					c80, c90, ca0, ca0, too_short, too_short, too_short, too_short,
+					too_short, too_short, too_short, too_short, too_short, too_short, too_short, too_short,
+					c80, c90, ca0, ca0, too_short, too_short, too_short, too_short
+				);
+				nibble = _mm256_set1_epi8(0x0f);
+				// 块末尾 3 字节中仍在等待后续字节的首字节
+				incomplete = _mm256_setr_epi8(
+					-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+					-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+					static_cast<char>(0xf0 - 1), static_cast<char>(0xe0 - 1), static_cast<char>(0xc0 - 1)
+				);
+			}
+
+			/** @brief 当前块整体右移 n 字节，空出的位置由上一块末尾填充 */
+			template<int _n>
+			static __m256i prev(__m256i cur, __m256i last)
+			{
+				return _mm256_alignr_epi8(cur, _mm256_permute2x128_si256(last, cur, 0x21), 16 - _n);
+			}
+
+			/** @return 非 0 表示 cur 所在块（连同上一块遗留的序列）存在错误 */
+			__m256i check(__m256i cur, __m256i last) const
+			{
+				__m256i prev1 = prev<1>(cur, last);
+				__m256i sc = _mm256_and_si256(
+					_mm256_and_si256(
+						_mm256_shuffle_epi8(byte_1_high, _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble)),
+						_mm256_shuffle_epi8(byte_1_low, _mm256_and_si256(prev1, nibble))
+					),
+					_mm256_shuffle_epi8(byte_2_high, _mm256_and_si256(_mm256_srli_epi16(cur, 4), nibble))
+				);
+				__m256i third = _mm256_subs_epu8(prev<2>(cur, last), _mm256_set1_epi8(static_cast<char>(0xe0 - 0x80)));
+				__m256i fourth = _mm256_subs_epu8(prev<3>(cur, last), _mm256_set1_epi8(static_cast<char>(0xf0 - 0x80)));
+				__m256i must23 = _mm256_and_si256(_mm256_or_si256(third, fourth), _mm256_set1_epi8(static_cast<char>(0x80)));
+				return _mm256_xor_si256(must23, sc);
+			}
+
+			/** @return 非 0 表示块末尾有未完成的多字节序列 */
+			__m256i is_incomplete(__m256i cur) const
+			{
+				return _mm256_subs_epu8(cur, incomplete);
+			}
+		};
+#endif
+
+		/**
+		 * \brief 校验 [p, end) 是否为合法的 UTF-8。AVX2 下逐 32 字节用 Keiser–Lemire 查表法校验，
+		 *        纯 ASCII 的块只检查上一块是否有未完成的序列；发现错误后从最近的字符边界逐字符定位。
+		 *        SSE2 没有字节查表指令，只做 ASCII 块的快速跳过
+		 * \return 第一个不合法序列的开头，全部合法返回 end
+		 */
+		inline const char* validate_utf8(const char* p, const char* end)
+		{
+#if defined(_SJSON_SIMD_AVX2)
+			if (end - p >= 32)
+			{
+				const char* beg = p;
+				// q 之前已校验过的部分中可能跨过 q 的序列的开头（前 3 字节中最近的首字节），没有则为 q
+				auto boundary = [beg](const char* q)
+					{
+						for (const char* r = q; r != beg && q - r < 3;)
+						{
+							auto b = static_cast<uint8_t>(*--r);
+							if (b < 0x80)break;
+							if (b >= 0xc0)return r;
+						}
+						return q;
+					};
+				static const utf8_tables tables;
+				__m256i last = _mm256_setzero_si256();
+				__m256i last_incomplete = _mm256_setzero_si256();
+				for (; end - p >= 32; p += 32)
+				{
+					__m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+					__m256i err = last_incomplete;
+					if (_mm256_movemask_epi8(x))
+					{
+						err = tables.check(x, last);
+						last_incomplete = tables.is_incomplete(x);
+					}
+					else last_incomplete = _mm256_setzero_si256();
+					if (!_mm256_testz_si256(err, err))return validate_utf8_scalar(boundary(p), end);
+					last = x;
+				}
+				p = boundary(p);
+			}
+#endif
+#if defined(_SJSON_SIMD_AVX2) || defined(_SJSON_SIMD_SSE2)
+			for (;;)
+			{
+				for (; end - p >= 16; p += 16)
+				{
+					__m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+					if (_mm_movemask_epi8(x))break;
+				}
+				if (end - p < 16)break;
+				// 逐字符越过这个含非 ASCII 字节的块，停在字符边界上
+				const char* stop = p + 16;
+				while (p < stop)
+				{
+					if (static_cast<uint8_t>(*p) < 0x80)
+					{
+						++p;
+						continue;
+					}
+					int n = utf8_seq_len(p, end);
+					if (!n)return p;
+					p += n;
+				}
+			}
+#endif
+			return validate_utf8_scalar(p, end);
+		}
+	};
+
+	/*
+	* 结构索引（解析的第一阶段）
+	* 按块扫描输入，记录字符串外每个 token 的起始偏移：
+	*   结构字符 {}[]:, 、字符串的起始引号、其余标量（数字/关键词等）的首字符
+	* lazy_document 以此建立 token 表；parse_parallel 切分输入时用同样的块掩码
+	*/
+	class structural_index
+	{
+	public:
+
+		/**
+		 * \param s 输入
+		 * \param n 输入长度
+		 * \return 是否建立成功（字符串外出现 '/'（注释）或 n 超出 uint32 范围时不建立）
+		 */
+		bool build(const char* s, size_t n)
+		{
+			_data.clear();
+			if (n >= max_uint32)return false;
+
+			uint64_t esc_carry = 0, str_carry = 0, sep_carry = 1;
+			for (size_t i = 0; i < n; i += 64)
+			{
+				simd::block_masks m;
+				uint64_t valid = ~uint64_t(0);
+				if (n - i >= 64)m = simd::classify_block(s + i);
+				else
+				{
+					char tmp[64];
+					std::memset(tmp, ' ', sizeof(tmp));
+					std::memcpy(tmp, s + i, n - i);
+					m = simd::classify_block(tmp);
+					valid = (uint64_t(1) << (n - i)) - 1;
+				}
+
+				uint64_t quote = m.quote & ~_escaped_of(m.backslash, esc_carry);
+				// 从起始引号（含）到结束引号（不含）之间的位为 1
+				uint64_t in_str = simd::prefix_xor(quote) ^ str_carry;
+				str_carry = uint64_t(0) - (in_str >> 63);
+
+				if (m.slash & ~in_str & valid)return false;
+
+				uint64_t sep = m.space | m.op | quote;
+				uint64_t scalar = ~sep & ~in_str & ((sep << 1) | sep_carry);
+				sep_carry = sep >> 63;
+
+				uint64_t tokens = ((m.op & ~in_str) | (quote & in_str) | scalar) & valid;
+				while (tokens)
+				{
+					_data.push_back(static_cast<uint32_t>(i + std::countr_zero(tokens)));
+					tokens &= tokens - 1;
+				}
+			}
+			return true;
+		}
+
+		const std::vector<uint32_t>& positions()const { return _data; }
+
+	private:
+
+		template<typename _json_t>
+		friend class parser;
+
+		std::vector<uint32_t> _data;
+
+		/**
+		 * \param bs 反斜杠掩码
+		 * \param carry 上一块末尾的反斜杠是否转义了本块的第一个字节，同时返回本块的对应结果
+		 * \return 被转义的字节的掩码
+		 */
+		static uint64_t _escaped_of(uint64_t bs, uint64_t& carry)
+		{
+			uint64_t esc = carry;
+			carry = 0;
+			bs &= ~esc;
+			while (bs)
+			{
+				int i = std::countr_zero(bs);
+				if (i == 63)
+				{
+					carry = 1;
+					break;
+				}
+				esc |= uint64_t(1) << (i + 1);
+				bs &= ~(uint64_t(3) << i);
+			}
+			return esc;
+		}
+	};
+
+	enum class parser_delimiter :uint32_t
+	{
+		comma = ',',
+		colon = ':',
+		left_bracket = '[',
+		right_bracket = ']',
+		left_brace = '{',
+		right_brace = '}'
+	};
+
+	template<typename _json_t>
+	class parser;
+
+};
+
+enum class json_value_t
+{
+	array,
+	object,
+
+	null,
+	num_double,
+	num_i32,
+	boolean,
+	string,
+
+	num_ui32, num_i64, num_ui64,
+
+	num_raw = 11 // 原样保存的数字（见 basic_raw_number），10 为解析时使用的分隔符
+};
+
+/*
+* 逐个读取时得到的 token 种类
+*/
+enum class json_token
+{
+	end, // 输入结束
+	start_object,
+	end_object,
+	start_array,
+	end_array,
+	key,
+	value, // 字符串/数字/布尔/null
+	abort // 错误回调要求中止
+};
+
+/*
+* 推送解析（feed）的状态
+*/
+enum class json_feed_status
+{
+	need_more, // 需要更多输入
+	done, // 解析完了一个值，可用 result() 取得
+	end, // 输入已结束且没有更多的值
+	abort // 错误回调要求中止
+};
+
+constexpr inline const char* json_type_name(json_value_t x)
+{
+	return x == json_value_t::array
+		? "array"
+		: (x == json_value_t::object ? "object" : "value");
+}
+constexpr const char* json_value_t_name(json_value_t x)
+{
+	constexpr const char* name_of[] =
+	{
+		"array", "object",
+		
+		"null",
+
+		"num.double", "num.int32", "num.boolean",
+		"string",
+
+		"num.uint32","num.int64","num.uint64",
+
+		"parser.delimiter",
+
+		"num.raw"
+	};
+
+	return static_cast<size_t>(x) < 12
+		? name_of[static_cast<size_t>(x)]
+		: "unknown";
+}
+
+enum class json_parse_error
+{
+	item_not_closed, // <注释/字符串/数组/对象> 未闭合，具体取决于 origin
+	illegal_escape, // 不符合规定的 <unicode/\xxx> 转义序列
+	invalid_unicode_code, // 无效的 unicode 码
+	unknown_keyword, // 未知的的关键词
+	/*
+	* msg 格式:
+	*   xxxxx@yyyyyy
+	* 以第一个 '@' 为分隔符
+	* 前面是期望值(<值类型> 或 {正则表达式}) 后面是实际值
+	*/
+	unexpected_item, // 意外的值/对象/字符
+	too_deep, // 容器的嵌套层数超过限制（msg 为限制的层数），该容器被跳过并当作 null
+	invalid_utf8, // 输入不是合法的 UTF-8（msg 为第一个不合法序列相对输入开头的字节偏移）
+};
+
+enum class json_callback_ret
+{
+	ignore_and_continue,
+	abort
+};
+enum class json_error_origin
+{
+	parse_comment,
+	parse_string,
+	parse_unicode,
+	parse_keyword,
+	parse_delimiter,
+	parse_array,
+	parse_object,
+	parse_number,
+	bind_value, // 直接读入结构体时值的类型与成员不符，或数字超出成员的范围
+	validate_utf8 // 校验输入的 UTF-8 编码（见 parser::validate_utf8）
+};
+
+using json_parse_error_callback_f = std::function<
+	json_callback_ret(
+		uint32_t line, uint32_t column,
+		json_error_origin origin,
+		json_parse_error e, const std::string& msg
+		)
+>;
+
+namespace _sjson_detail
+{
+	json_callback_ret defult_parse_err_callback(
+		uint32_t line, uint32_t column,
+		json_error_origin origin,
+		json_parse_error e, const std::string& msg
+	);
+}
+
+/*
+* ecode:
+* 0 try failed
+* 1 bad call: call xxx method on yyy
+*/
+
+class json_error :public std::exception
+{
+public:
+	
+	json_error(const char* s, int ec) :_what(s), _err_code(ec) {}
+	json_error(const std::string& s, int ec = 0) :_what(s), _err_code(ec) {}
+	json_error(int line, const char* func, const std::string& str, int ec)
+		: _what(std::string("sjson.hpp:") + std::to_string(line) +
+			':' + func + (ec ? ":[json_error." + std::to_string(ec) + "] " : ": ")  + str), _err_code(ec) {}
+
+	int error_code()const { return _err_code; }
+
+	virtual const char* what()const
+	{
+		return _what.c_str();
 	}
 
 private:
@@ -344,1324 +1141,6013 @@ _JSON_THROW_TYPE_ADJUST_RAW(json_value_t_name(dest), json_value_t_name(need))
 
 #pragma endregion
 
-template<
-	typename _string_t = std::string,
-	// 后面必须要有 typename ... 之类的东西（用来满足 vector 和 map 的模板参数）否则会导致被其他模板使用时编译失败
-	template<typename _key_t, typename _val_t, typename ...> typename _map_t = std::unordered_map,
-	template<typename _val_t, typename ...> typename _arr_t = std::vector
->
-class _basic_json
+/*
+* 原样保存的数字（见 _sjson_detail::parser::set_raw_numbers）：解析时只记录数字的原文与简单的分类，
+* 以数值类型读取时才转换，dump 时原样写回，因此大整数与高精度小数不会丢失精度
+*/
+template<typename _string_t>
+struct basic_raw_number
 {
-private:
+	_string_t text;
+	bool integral = false; // 不含小数点与指数
+	bool fits_int64 = false; // 整数且不超过 18 位数字，一定能用 int64_t 表示（转换为整数时不检查溢出）
 
-	template <class _list, class _t>
-	struct _meta_find_idx {
-		static constexpr size_t value = -1;
-	};
+	bool operator==(const basic_raw_number& x)const { return text == x.text; }
+};
 
-	static constexpr size_t _meta_find_idx_func(const bool* const _Ptr, const size_t _Count,
-		size_t _Idx = 0) {
-
-		for (; _Idx < _Count; ++_Idx) {
-			if (_Ptr[_Idx]) {
-				return _Idx;
-			}
-		}
-		return -1;
-	}
+namespace _sjson_detail
+{
+	template<typename _t, typename = void>
+	struct is_pmr_string :std::false_type {};
+	template<typename _t>
+	struct is_pmr_string<_t, std::void_t<typename _t::allocator_type>>
+		:std::is_same<typename _t::allocator_type, std::pmr::polymorphic_allocator<typename _t::value_type>> {};
 
-	template <template <class...> class _list, class _first, class... _rest, class _t>
-	struct _meta_find_idx<_list<_first, _rest...>, _t>
+	/*
+	* _basic_json 的基类：字符串类型使用 std::pmr 的分配器时，每个结点记录自己的内存资源，
+	* 结点内新建的字符串与容器都从它分配；否则为空（不占空间）
+	*/
+	template<bool _pmr>
+	struct json_alloc_base {};
+	template<>
+	struct json_alloc_base<true>
 	{
-		static constexpr bool _bools[] = { std::is_same_v<_first, _t>, std::is_same_v<_rest, _t>... };
-		static constexpr size_t value = _meta_find_idx_func(_bools, 1 + sizeof...(_rest));
-	};
-
-	class _my_initializer_list;
-
-public:
-
-	using string_t = _string_t;
-	using string_char_t = typename _string_t::value_type;
-
-	using array_t = _arr_t<_basic_json>;
-	using object_t = _map_t<string_t, _basic_json>;
-
-private:
+		using allocator_type = std::pmr::polymorphic_allocator<std::byte>;
 
-	std::variant<
-		array_t, object_t,
-		nullptr_t, double, int32_t, bool,
-		string_t,
-		uint32_t, int64_t, uint64_t,
-
-		_sjson_detail::parser_delimiter
-	> _data;
-
-	static constexpr json_value_t _json_value_parser_delimiter = static_cast<json_value_t>(10);
+		std::pmr::memory_resource* _res = std::pmr::get_default_resource();
 
-	template<typename _t>
-	using _enable_if_can_assign = typename std::enable_if<
-		!std::is_same<_t, decltype(_data)>::value &&
-		std::is_constructible<decltype(_data), _t>::value,
-	int>::type;
+		json_alloc_base() = default;
+		explicit json_alloc_base(std::pmr::memory_resource* res) :_res(res) {}
+		// 与 std::pmr 的容器相同：复制构造使用默认资源，移动时随内容一起转移，赋值时保持不变
+		json_alloc_base(const json_alloc_base&) {}
+		json_alloc_base(json_alloc_base&&) noexcept = default;
+		json_alloc_base& operator=(const json_alloc_base&) { return *this; }
 
-	size_t _type_raw() const { return _data.index(); }
+		allocator_type get_allocator()const { return allocator_type(_res); }
+	};
 
-public:
-		
-	/**
-	 * @brief 初始化为一个空的 json
-	*/
-	_basic_json() :_data(nullptr) {}
-		
-	/**
-	 * @brief 使用 x 初始化 json
-	 * @tparam _t 可接受的数据类型（详见 json_value_t）
-	 * @param x 用于初始化的值
-	*/
-	template <typename _t, _enable_if_can_assign<_t> = 0>
-	_basic_json(const _t& x) { assign(x); }
+	// 用于 _basic_json<std::pmr::string, pmr_unordered_map, pmr_vector>（见 sjson::pmr_json）
+	template<typename _key_t, typename _val_t, typename ...>
+	using pmr_unordered_map = std::pmr::unordered_map<_key_t, _val_t>;
+	template<typename _val_t, typename ...>
+	using pmr_vector = std::pmr::vector<_val_t>;
 
-	_basic_json(const std::initializer_list<_my_initializer_list>& x)
+	// 64 位乘法：a 与 b 分别改为 128 位积的低 64 位与高 64 位
+	inline void mul128(uint64_t& a, uint64_t& b)
 	{
-		assign(_my_initializer_list(x).data());
+#if defined(__SIZEOF_INT128__)
+		unsigned __int128 r = static_cast<unsigned __int128>(a) * b;
+		a = static_cast<uint64_t>(r);
+		b = static_cast<uint64_t>(r >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+		a = _umul128(a, b, &b);
+#else
+		uint64_t a0 = a & 0xffffffff, a1 = a >> 32, b0 = b & 0xffffffff, b1 = b >> 32;
+		uint64_t p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0, p11 = a1 * b1;
+		uint64_t mid = (p00 >> 32) + (p01 & 0xffffffff) + (p10 & 0xffffffff);
+		a = (p00 & 0xffffffff) | (mid << 32);
+		b = p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
+#endif
+	}
+	// 128 位积的低 64 位与高 64 位的异或
+	inline uint64_t mul_fold(uint64_t a, uint64_t b)
+	{
+		mul128(a, b);
+		return a ^ b;
 	}
 
-	_basic_json(json_value_t t)
+	/**
+	 * \brief wyhash 式的字节串哈希：每 16 字节做一次 64 位乘法折叠，不超过 16 字节的键只需两次乘法
+	 * \param seed 种子，不同的种子得到互不相关的哈希（见 hash_seed）
+	 */
+	inline uint64_t hash_bytes(const void* data, size_t len, uint64_t seed)
 	{
-		switch (t)
+		constexpr uint64_t s0 = 0xa0761d6478bd642full, s1 = 0xe7037ed1a0b428dbull;
+		constexpr uint64_t s2 = 0x8ebc6af09c88c6e3ull, s3 = 0x589965cc75374cc3ull;
+		auto r8 = [](const uint8_t* p) { uint64_t v; std::memcpy(&v, p, 8); return v; };
+		auto r4 = [](const uint8_t* p) { uint32_t v; std::memcpy(&v, p, 4); return static_cast<uint64_t>(v); };
+
+		const uint8_t* p = static_cast<const uint8_t*>(data);
+		seed ^= mul_fold(seed ^ s0, s1);
+		uint64_t a = 0, b = 0;
+		if (len <= 16)
 		{
-		case json_value_t::array: assign(array_t()); break;
-		case json_value_t::object: assign(object_t()); break;
-		case json_value_t::null: assign(nullptr); break;
-		case json_value_t::num_double: assign(0.0); break;
-		case json_value_t::num_i32: assign(0); break;
-		case json_value_t::boolean: assign(false); break;
-		case json_value_t::string: assign(_string_t()); break;
-		case json_value_t::num_ui32: assign(0U); break;
-		case json_value_t::num_i64: assign(0LL); break;
-		case json_value_t::num_ui64:assign(0ULL); break;
-		default:
-			break;
+			if (len >= 4)
+			{
+				size_t d = (len >> 3) << 2;
+				a = (r4(p) << 32) | r4(p + d);
+				b = (r4(p + len - 4) << 32) | r4(p + len - 4 - d);
+			}
+			else if (len)a = (static_cast<uint64_t>(p[0]) << 16) | (static_cast<uint64_t>(p[len >> 1]) << 8) | p[len - 1];
+		}
+		else
+		{
+			size_t i = len;
+			if (i > 48)
+			{
+				uint64_t seed1 = seed, seed2 = seed;
+				do
+				{
+					seed = mul_fold(r8(p) ^ s1, r8(p + 8) ^ seed);
+					seed1 = mul_fold(r8(p + 16) ^ s2, r8(p + 24) ^ seed1);
+					seed2 = mul_fold(r8(p + 32) ^ s3, r8(p + 40) ^ seed2);
+					p += 48;
+					i -= 48;
+				} while (i > 48);
+				seed ^= seed1 ^ seed2;
+			}
+			for (; i > 16; i -= 16, p += 16)seed = mul_fold(r8(p) ^ s1, r8(p + 8) ^ seed);
+			a = r8(p + i - 16);
+			b = r8(p + i - 8);
 		}
+		a ^= s1;
+		b ^= seed;
+		mul128(a, b);
+		return mul_fold(a ^ s0 ^ len, b ^ s1);
 	}
 
-	json_value_t type()const { return static_cast<json_value_t>(_type_raw()); }
-	
-	const char* type_name()const { return json_type_name(type()); }
-	const char* value_t_name()const { return json_value_t_name(type()); }
+	/*
+	* 进程级的随机哈希种子：相同的键在不同进程中的哈希不同，使构造大量冲突键的输入难以预先准备。
+	* 定义了 _SJSON_HASH_SEED 时固定为它（输出可以复现，但失去上述保护）
+	*/
+	inline uint64_t hash_seed()
+	{
+#if defined(_SJSON_HASH_SEED)
+		return static_cast<uint64_t>(_SJSON_HASH_SEED);
+#else
+		static const uint64_t seed = []
+			{
+				std::random_device rd;
+				return (static_cast<uint64_t>(rd()) << 32) ^ rd() ^ reinterpret_cast<uintptr_t>(&rd);
+			}();
+		return seed;
+#endif
+	}
+}
 
+/*
+* 按插入顺序连续保存键值对的对象容器，可作为 _basic_json 的 _map_t（见 flat_json），键为字符串类型。
+* 元素不超过 linear_max 个时按键的 1 字节摘要（长度与首、中、尾字符）每次比较 16 个（SSE2），
+* 只对摘要相同的元素比较键，不计算哈希也不为索引分配内存；超过后另建开放寻址的哈希索引。
+* 适合键不多的对象：比 std::unordered_map 少了桶数组与逐个结点的分配，遍历（如 dump）也是顺序访问。
+* 元素保存为 std::pair<key, value>，插入可能使迭代器失效，erase 需要移动后面的元素
+*/
+template<typename _key_t, typename _val_t, typename ...>
+class flat_map
+{
+	using _view_t = std::basic_string_view<typename _key_t::value_type>;
+	static constexpr size_t _npos = static_cast<size_t>(-1);
 
-	/**
-	 * @brief 清空当前的数据（设为 nullptr）
-	*/
-	void clear() { _data = nullptr; }
+public:
 
-	// assign
-	#pragma region assign
+	using key_type = _key_t;
+	using mapped_type = _val_t;
+	using value_type = std::pair<_key_t, _val_t>;
+	using size_type = size_t;
+	using iterator = typename std::vector<value_type>::iterator;
+	using const_iterator = typename std::vector<value_type>::const_iterator;
 
-	/**
-	 * @brief 初始化为空
-	*/
-	void assign() { clear(); }
-	
-	/**
-	 * @brief 通过 可被接受的数据 构造
-	 * @tparam _t 可接受的数据类型（详见 json_value_t）
-	 * @param x 可接受的数据
-	*/
-	template <typename _t, _enable_if_can_assign<_t> = 0>
-	void assign(const _t& x) { _data = x; }
-	
-	/**
-	 * @brief 通过 字符指针/数组 构造
-	 * @param str 字符串
-	*/
-	void assign(const string_char_t* str) // 防止 char* 被当成 bool 错误调用
+	static constexpr size_t linear_max = 16;
+
+	flat_map() = default;
+	flat_map(std::initializer_list<value_type> x)
 	{
-		_data = std::move(string_t(str));
+		for (const auto& kv : x)insert(kv);
 	}
 
-	/**
-	 * @brief 通过 另一个 json 值 构造
-	 * @param x 指定的 json
-	*/
-	void assign(const _basic_json& x) { _data = x._data; }
+	iterator begin() { return _items.begin(); }
+	iterator end() { return _items.end(); }
+	const_iterator begin()const { return _items.begin(); }
+	const_iterator end()const { return _items.end(); }
+	const_iterator cbegin()const { return _items.begin(); }
+	const_iterator cend()const { return _items.end(); }
 
-	#pragma endregion
+	size_t size()const { return _items.size(); }
+	bool empty()const { return _items.empty(); }
 
-	const _basic_json& operator=(const _basic_json& x)
+	void clear()
 	{
-		assign(x);
-		return x;
+		_items.clear();
+		_tags.clear();
+		_index.clear();
 	}
-
-	// hold
-
-	/**
-	 * @brief 检查持有类型是否为 _t
-	 * @tparam _t 要检查的类型
-	 * @return 是否持有
-	*/
-	template<typename _t>
-	bool hold()const noexcept { return std::holds_alternative<_t>(_data); }
-	
-	/**
-	 * @brief 检查持有类型的编号是否为 _idx
-	 * @return 是否持有
-	*/
-	template<json_value_t _idx>
-	bool hold()const noexcept
+	void reserve(size_t n)
 	{
-		return hold<
-			std::variant_alternative_t<
-				static_cast<size_t>(_idx), decltype(_data)
-			>
-		>();
+		_items.reserve(n);
+		_tags.reserve(_round_tags(n));
 	}
 
-	/**
-	 * @brief 检查是否持有 值 类型
-	 * @return 是否持有
-	 */
-	bool hole_value_type()const noexcept
+	iterator find(_view_t key)
 	{
-		auto t = type();
-		if (t == json_value_t::array
-			|| t == json_value_t::object
-			|| t == _json_value_parser_delimiter
-			)return false;
-		return true;
+		size_t i = _find(key);
+		return i == _npos ? end() : begin() + i;
 	}
+	const_iterator find(_view_t key)const
+	{
+		size_t i = _find(key);
+		return i == _npos ? end() : begin() + i;
+	}
+	size_t count(_view_t key)const { return _find(key) != _npos; }
+	bool contains(_view_t key)const { return _find(key) != _npos; }
 
-	// get
-	#pragma region get
-
-#define _TYPE_OF_IDX std::variant_alternative_t<static_cast<size_t>(_idx), decltype(_data)>
-
-	/**
-	 * @brief 尝试获取指定类型数据
-	 * @tparam _t 类型
-	 * @return 指向目标数据的指针，如持有类型非 _t 则返回空指针
-	*/
-	template<typename _t>
-	_t* get_if() { return std::get_if<_t>(&_data); }
-	/**
-	 * @brief 尝试获取指定类型数据
-	 * @tparam _t 类型
-	 * @return 指向目标数据的指针，如持有类型非 _t 则返回空指针
-	*/
-	template<typename _t>
-	const _t* get_if()const { return std::get_if<_t>(&_data); }
-	/**
-	 * @brief 尝试获取指定类型数据
-	 * @tparam _idx 类型的编号
-	 * @return 指向目标数据的指针，如持有类型非 _idx 所对应则返回空指针
-	*/
-	template<json_value_t _idx>
-	_TYPE_OF_IDX* get_if() { return std::get_if<static_cast<size_t>(_idx)>(&_data); }
-	/**
-	 * @brief 尝试获取指定类型数据
-	 * @tparam _idx 类型的编号
-	 * @return 指向目标数据的指针，如持有类型非 _idx 所对应则返回空指针
-	*/
-	template<json_value_t _idx>
-	const _TYPE_OF_IDX* get_if()const { return std::get_if<static_cast<size_t>(_idx)>(&_data); }
-
-	// get<_t>
-
-	/**
-	 * @brief 获取指定类型数据
-	 * @tparam _t 类型
-	 * @return 目标数据，如持有类型非 _t 则将当前值调整为 _t 后返回。（定义 _SJSON_DISABLE_AUTO_TYPE_ADJUST 则会抛出错误代替调整）
-	*/
-	template<typename _t>
-	_t& get()
+	_val_t& at(_view_t key)
 	{
-		_JSON_ENSURE_IS(_t);
-		return std::get<_t>(_data);
+		return const_cast<_val_t&>(std::as_const(*this).at(key));
 	}
-	/**
-	 * @brief 获取指定类型数据
-	 * @tparam _t 类型
-	 * @return 目标数据，如持有类型非 _t 则返回一个静态常量值的引用。（定义 _SJSON_DISABLE_AUTO_TYPE_ADJUST 则会抛出错误）
-	*/
-	template<typename _t>
-	const _t& get()const
+	const _val_t& at(_view_t key)const
 	{
-		_JSON_ENSURE_IS(_t);
-		return hold<_t>() ? std::get<_t>(_data) : _make_tmp<_t>();
+		size_t i = _find(key);
+		if (i == _npos)throw std::out_of_range("flat_map::at");
+		return _items[i].second;
 	}
 
-	// get<_idx>
-
-	/**
-	 * @brief 获取指定类型数据
-	 * @tparam _idx 类型的序号
-	 * @return 目标数据，如持有类型非 _t 则将当前值调整为 _idx 所对应类型后返回。（定义 _SJSON_DISABLE_AUTO_TYPE_ADJUST 则会抛出错误代替调整）
-	*/
-	template<json_value_t _idx>
-	inline _TYPE_OF_IDX& get()
+	_val_t& operator[](const _key_t& key)
 	{
-		return get<_TYPE_OF_IDX>();
+		size_t i = _find(key);
+		return i == _npos ? _append(key)->second : _items[i].second;
 	}
-	/**
-	 * @brief 获取指定类型数据
-	 * @tparam _idx 类型的序号
-	 * @return 目标数据，如持有类型非 _idx 所对应类型则返回一个静态常量值的引用。（定义 _SJSON_DISABLE_AUTO_TYPE_ADJUST 则会抛出错误）
-	*/
-	template<json_value_t _idx>
-	inline const _TYPE_OF_IDX& get()const
+	_val_t& operator[](_key_t&& key)
 	{
-		return get<_TYPE_OF_IDX>();
+		size_t i = _find(key);
+		return i == _npos ? _append(std::move(key))->second : _items[i].second;
 	}
 
-#undef _TYPE_OF_IDX
-
-	#pragma endregion
-
-	#pragma region operator
-
-	// operator ==
-
-	bool operator == (const _basic_json& j)const
+	template<typename _k, typename... _args>
+	std::pair<iterator, bool> try_emplace(_k&& key, _args&&... args)
 	{
-		return _data == j._data;
+		size_t i = _find(key);
+		if (i != _npos)return { begin() + i, false };
+		return { _append(std::forward<_k>(key), std::forward<_args>(args)...), true };
 	}
-	template <typename _t, _enable_if_can_assign<_t> = 0>
-	bool operator == (const _t& val)const
+	template<typename _k, typename _v>
+	std::pair<iterator, bool> emplace(_k&& key, _v&& val)
 	{
-		return _data == _basic_json(val)._data;
+		return try_emplace(std::forward<_k>(key), std::forward<_v>(val));
 	}
+	std::pair<iterator, bool> insert(const value_type& kv) { return try_emplace(kv.first, kv.second); }
+	std::pair<iterator, bool> insert(value_type&& kv) { return try_emplace(std::move(kv.first), std::move(kv.second)); }
 
-	// operator _t
-
-	inline operator const array_t& () const { return get<array_t>(); }
-	inline operator const object_t& () const { return get<object_t>(); }
-	template <
-		typename _t,
-		typename std::enable_if_t<
-		!(
-			// 消除 string 歧义
-			std::is_pointer_v<_t> // [const] char* [const]
-			|| std::is_same_v<_t, string_char_t>
-			|| std::is_same_v<_t, std::initializer_list<string_char_t> >
-			), int
-		> = 0
-	> inline operator _t () const { return get<_t>(); }
-
-	// operator []
-	
-	// 如果超出数组范围，会更改大小
-	_basic_json& operator[](size_t idx)
+	iterator erase(const_iterator pos)
 	{
-		_JSON_TRY(get<array_t>());
-		auto& arr = get<array_t>();
-		if (idx >= arr.size())arr.resize(idx + 1);
-		return arr[idx];
+		size_t i = pos - begin();
+		auto res = _items.erase(pos);
+		std::memmove(_tags.data() + i, _tags.data() + i + 1, _items.size() - i);
+		_tags.resize(_round_tags(_items.size()));
+		_rebuild_index();
+		return res;
 	}
-	const _basic_json& operator[](size_t idx)const
+	size_t erase(_view_t key)
 	{
-		_JSON_TRY(return get<array_t>()[idx]);
+		size_t i = _find(key);
+		if (i == _npos)return 0;
+		erase(begin() + i);
+		return 1;
 	}
 
-	_basic_json& operator[](const string_t& key)
+	// 与 std::unordered_map 相同，不考虑顺序
+	bool operator==(const flat_map& x)const
 	{
-		_JSON_TRY(return get<object_t>()[key]);
+		if (size() != x.size())return false;
+		for (const auto& kv : _items)
+		{
+			size_t i = x._find(kv.first);
+			if (i == _npos || !(x._items[i].second == kv.second))return false;
+		}
+		return true;
 	}
-	const _basic_json& operator[](const string_t& key)const
+
+private:
+
+	std::vector<value_type> _items;
+	// 各元素的键的摘要，长度补齐到 16 的倍数以便整块比较
+	std::vector<uint8_t> _tags;
+	// 元素多于 linear_max 时的哈希索引（线性探测，保存下标 + 1，0 为空），容量为 2 的幂且至少为元素个数的两倍
+	std::vector<uint32_t> _index;
+
+	static size_t _round_tags(size_t n) { return (n + 15) & ~size_t(15); }
+
+	static uint8_t _tag(_view_t k)
 	{
-		_JSON_TRY(get<object_t>());
-		const auto& obj = get<object_t>();
-		const auto& it = obj.find(key);
-		return (it == obj.end()) ? _make_tmp<_basic_json>() : it->second;
+		size_t n = k.size();
+		if (!n)return 0;
+		auto c = [&](size_t i) { return static_cast<size_t>(static_cast<std::make_unsigned_t<typename _view_t::value_type>>(k[i])); };
+		return static_cast<uint8_t>(n ^ (c(0) << 1) ^ (c(n / 2) * 5) ^ (c(n - 1) << 3));
 	}
+	static size_t _hash(_view_t k) { return std::hash<_view_t>()(k); }
 
-	// 不使用 string_char_t* 以防 0 被错误识别
+	size_t _find(_view_t key)const
+	{
+		size_t n = _items.size();
+		if (!_index.empty())
+		{
+			size_t mask = _index.size() - 1;
+			for (size_t h = _hash(key) & mask; _index[h]; h = (h + 1) & mask)
+			{
+				size_t i = _index[h] - 1;
+				if (_view_t(_items[i].first) == key)return i;
+			}
+			return _npos;
+		}
+		uint8_t t = _tag(key);
+		for (size_t base = 0; base < n; base += 16)
+		{
+			uint32_t m = _sjson_detail::simd::match_byte16(_tags.data() + base, t);
+			if (n - base < 16)m &= (1u << (n - base)) - 1;
+			for (; m; m &= m - 1)
+			{
+				size_t i = base + std::countr_zero(m);
+				if (_view_t(_items[i].first) == key)return i;
+			}
+		}
+		return _npos;
+	}
 
-	template <typename _t>
-	_basic_json& operator[](const _t* const key)
+	template<typename _k, typename... _args>
+	iterator _append(_k&& key, _args&&... args)
 	{
-		return this->operator[](std::move(string_t(key)));
+		_items.emplace_back(
+			std::piecewise_construct,
+			std::forward_as_tuple(std::forward<_k>(key)),
+			std::forward_as_tuple(std::forward<_args>(args)...)
+		);
+		size_t n = _items.size();
+		_tags.resize(_round_tags(n));
+		_tags[n - 1] = _tag(_items.back().first);
+		if (n > linear_max)
+		{
+			if (n * 2 > _index.size())_rebuild_index();
+			else _index_insert(n - 1);
+		}
+		return _items.end() - 1;
 	}
-	template <typename _t>
-	const _basic_json& operator[](const _t* const key)const
+
+	void _index_insert(size_t i)
 	{
-		return this->operator[](std::move(string_t(key)));
+		size_t mask = _index.size() - 1;
+		size_t h = _hash(_items[i].first) & mask;
+		while (_index[h])h = (h + 1) & mask;
+		_index[h] = static_cast<uint32_t>(i + 1);
+	}
+	void _rebuild_index()
+	{
+		size_t n = _items.size();
+		if (n <= linear_max)
+		{
+			_index.clear();
+			return;
+		}
+		_index.assign(std::bit_ceil(n * 4), 0);
+		for (size_t i = 0; i < n; ++i)_index_insert(i);
 	}
+};
 
-#pragma endregion
+/*
+* Swiss table 式的开放寻址哈希表，可作为 _basic_json 的 _map_t（见 swiss_json），键为字符串类型。
+* 键值对直接保存在槽数组中，另有每槽 1 字节的控制字节（空、已删除或哈希的低 7 位）：
+* 查找时按 16 个槽一组同时比较控制字节（SSE2），只对低 7 位相同的槽比较键，
+* 通常只访问一组控制字节与一个槽，没有 std::unordered_map 逐个结点的指针跳转。
+* 哈希为带进程级随机种子的 wyhash 式哈希（见 _sjson_detail::hash_bytes）。
+* 适合键很多的对象（如 id 到记录的字典）；不保持插入顺序，插入可能使迭代器失效。
+* 遍历顺序取决于哈希种子，同一进程内相同的插入序列得到相同的顺序，不同进程之间则不同（见 _SJSON_HASH_SEED）
+*/
+template<typename _key_t, typename _val_t, typename ...>
+class swiss_map
+{
+	using _view_t = std::basic_string_view<typename _key_t::value_type>;
+	static constexpr size_t _npos = static_cast<size_t>(-1);
+	static constexpr uint8_t _empty = 0x80, _deleted = 0xfe; // 占用的槽为哈希的低 7 位（最高位为 0）
 
-	/**
-	 * \param out 用于存放格式化后的字符串
-	 * \param tabstop 缩进长度
-	 * \param space 缩进字符
-	 * \param ensure_ascii 是否需要转换成 ASCII 格式（字符串会被强行当成 UTF-8 格式处理）
-	 */
-	void dump_to(std::string& out, int tabstop = -1, char space = ' ', bool ensure_ascii = true)const
+public:
+
+	using key_type = _key_t;
+	using mapped_type = _val_t;
+	using value_type = std::pair<_key_t, _val_t>;
+	using size_type = size_t;
+
+	template<bool _const>
+	class basic_iterator
 	{
-		if (tabstop < 0)tabstop = 4;
-		_dump_to(out, tabstop, space, ensure_ascii);
+		friend class swiss_map;
+		template<bool> friend class basic_iterator;
+		using _slot_t = std::conditional_t<_const, const typename swiss_map::value_type, typename swiss_map::value_type>;
+
+		const uint8_t* _ctrl = nullptr;
+		const uint8_t* _end = nullptr;
+		_slot_t* _slot = nullptr;
+
+		basic_iterator(const uint8_t* ctrl, const uint8_t* end, _slot_t* slot) :_ctrl(ctrl), _end(end), _slot(slot)
+		{
+			_skip();
+		}
+		// 跳过空的与已删除的槽
+		void _skip()
+		{
+			while (_ctrl != _end && (*_ctrl & 0x80))
+			{
+				++_ctrl;
+				++_slot;
+			}
+		}
+
+	public:
+
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = typename swiss_map::value_type;
+		using difference_type = std::ptrdiff_t;
+		using pointer = _slot_t*;
+		using reference = _slot_t&;
+
+		basic_iterator() = default;
+		template<bool _c, std::enable_if_t<_const && !_c, int> = 0>
+		basic_iterator(const basic_iterator<_c>& x) :_ctrl(x._ctrl), _end(x._end), _slot(x._slot) {}
+
+		reference operator*()const { return *_slot; }
+		pointer operator->()const { return _slot; }
+		basic_iterator& operator++()
+		{
+			++_ctrl;
+			++_slot;
+			_skip();
+			return *this;
+		}
+		basic_iterator operator++(int)
+		{
+			basic_iterator res = *this;
+			++*this;
+			return res;
+		}
+		bool operator==(const basic_iterator& x)const { return _ctrl == x._ctrl; }
+	};
+	using iterator = basic_iterator<false>;
+	using const_iterator = basic_iterator<true>;
+
+	swiss_map() = default;
+	swiss_map(std::initializer_list<value_type> x)
+	{
+		reserve(x.size());
+		for (const auto& kv : x)insert(kv);
 	}
-	/** 
-	 * \param tabstop 缩进长度
-	 * \param space 缩进字符
-	 * \param ensure_ascii 是否需要转换成 ASCII 格式（字符串会被强行当成 UTF-8 格式处理）
-	 * \return 格式化结果
-	 */
-	std::string dump(int tabstop = -1, char space = ' ', bool ensure_ascii = true)const
+	swiss_map(const swiss_map& x)
 	{
-		std::string res;
-		dump_to(res, tabstop, space, ensure_ascii);
-		return res;
+		reserve(x._size);
+		for (const auto& kv : x)_emplace_new(_hash(kv.first), kv.first, kv.second);
+	}
+	swiss_map(swiss_map&& x) noexcept { swap(x); }
+	swiss_map& operator=(swiss_map x) noexcept
+	{
+		swap(x);
+		return *this;
 	}
+	~swiss_map() { _release(); }
 
-	friend std::istream& operator>>(std::istream& is, _basic_json& j)
+	void swap(swiss_map& x) noexcept
 	{
-		_sjson_detail::parser<_basic_json>(is).get_result_to(j);
-		return is;
+		_ctrl.swap(x._ctrl);
+		std::swap(_slots, x._slots);
+		std::swap(_cap, x._cap);
+		std::swap(_size, x._size);
+		std::swap(_growth_left, x._growth_left);
 	}
 
-	void push_back(const _basic_json& j)
+	iterator begin() { return _iter(0); }
+	iterator end() { return _iter(_cap); }
+	const_iterator begin()const { return _iter(0); }
+	const_iterator end()const { return _iter(_cap); }
+	const_iterator cbegin()const { return _iter(0); }
+	const_iterator cend()const { return _iter(_cap); }
+
+	size_t size()const { return _size; }
+	bool empty()const { return !_size; }
+
+	// 保留已分配的槽
+	void clear()
 	{
-		if (hold<array_t>())get<array_t>().push_back(j);
-		else
+		for (size_t i = 0; i < _cap; ++i)
 		{
-
+			if (!(_ctrl[i] & 0x80))std::destroy_at(_slots + i);
 		}
+		if (_cap)std::memset(_ctrl.get(), _empty, _cap);
+		_size = 0;
+		_growth_left = _max_load(_cap);
+	}
+	void reserve(size_t n)
+	{
+		if (n > _size + _growth_left)_rehash(_cap_for(n));
 	}
 
-	size_t size()
+	iterator find(_view_t key)
 	{
-		if (hold<array_t>())return get<array_t>().size();
-		else if (hold<object_t>())return get<object_t>().size();
-		// TOOD 抛出错误不能对值使用 size()
-		return 0;
+		size_t i = _find(key, _hash(key));
+		return i == _npos ? end() : _iter(i);
+	}
+	const_iterator find(_view_t key)const
+	{
+		size_t i = _find(key, _hash(key));
+		return i == _npos ? end() : _iter(i);
 	}
+	size_t count(_view_t key)const { return _find(key, _hash(key)) != _npos; }
+	bool contains(_view_t key)const { return _find(key, _hash(key)) != _npos; }
 
-private:
+	_val_t& at(_view_t key)
+	{
+		return const_cast<_val_t&>(std::as_const(*this).at(key));
+	}
+	const _val_t& at(_view_t key)const
+	{
+		size_t i = _find(key, _hash(key));
+		if (i == _npos)throw std::out_of_range("swiss_map::at");
+		return _slots[i].second;
+	}
 
-	template<typename _t>
-	static inline const _t& _make_tmp()
+	_val_t& operator[](const _key_t& key) { return try_emplace(key).first->second; }
+	_val_t& operator[](_key_t&& key) { return try_emplace(std::move(key)).first->second; }
+
+	template<typename _k, typename... _args>
+	std::pair<iterator, bool> try_emplace(_k&& key, _args&&... args)
 	{
-		static const _t tmp = _t();
-		return tmp;
+		uint64_t h = _hash(key);
+		size_t i = _find(key, h);
+		if (i != _npos)return { _iter(i), false };
+		return { _iter(_emplace_new(h, std::forward<_k>(key), std::forward<_args>(args)...)), true };
+	}
+	template<typename _k, typename _v>
+	std::pair<iterator, bool> emplace(_k&& key, _v&& val)
+	{
+		return try_emplace(std::forward<_k>(key), std::forward<_v>(val));
 	}
+	std::pair<iterator, bool> insert(const value_type& kv) { return try_emplace(kv.first, kv.second); }
+	std::pair<iterator, bool> insert(value_type&& kv) { return try_emplace(std::move(kv.first), std::move(kv.second)); }
 
-	template<json_value_t _idx>
-	bool _ensure_is()
+	iterator erase(const_iterator pos)
 	{
-		using _t = std::variant_alternative_t<static_cast<size_t>(_idx), decltype(_data)>;
-		if (!hold<_t>())
+		size_t i = pos._ctrl - _ctrl.get();
+		std::destroy_at(_slots + i);
+		--_size;
+		// 所在组还有空槽时，没有键的探测越过这一组，可以直接置空；否则标记为已删除以免截断其他键的探测
+		if (_sjson_detail::simd::match_byte16(_ctrl.get() + (i & ~size_t(15)), _empty))
 		{
-			if (!hold<nullptr_t>())
-			{
-				_JSON_THROW_TYPE_ADJUST(type(), _idx);
-			}
-			_data = _t();
+			_ctrl[i] = _empty;
+			++_growth_left;
 		}
-		return true;
+		else _ctrl[i] = _deleted;
+		return _iter(i);
 	}
-	template<typename _t>
-	bool _ensure_is()
+	size_t erase(_view_t key)
 	{
-		return _ensure_is<
-			static_cast<json_value_t>(_meta_find_idx<decltype(_data), _t>::value)
-		>();
+		size_t i = _find(key, _hash(key));
+		if (i == _npos)return 0;
+		erase(_iter(i));
+		return 1;
 	}
 
-	template<json_value_t _idx>
-	bool _ensure_is()const
+	// 与 std::unordered_map 相同，不考虑顺序
+	bool operator==(const swiss_map& x)const
 	{
-		if (!hold<_idx>())
+		if (_size != x._size)return false;
+		for (const auto& kv : *this)
 		{
-			if (hold<nullptr_t>())return false;
-			_JSON_THROW_TYPE_ADJUST(type(), _idx);
-			// 如果没有定义 _SJSON_DISABLE_AUTO_TYPE_ADJUST 则该语句无效，会在调用 get 处调整
+			auto it = x.find(kv.first);
+			if (it == x.end() || !(it->second == kv.second))return false;
 		}
 		return true;
 	}
-	template<typename _t>
-	bool _ensure_is()const
+
+private:
+
+	std::unique_ptr<uint8_t[]> _ctrl; // 各槽的控制字节
+	value_type* _slots = nullptr;
+	size_t _cap = 0; // 槽数，为 0 或不小于 16 的 2 的幂
+	size_t _size = 0;
+	size_t _growth_left = 0; // 还能占用的空槽数（最大负载为 7/8，已删除的槽不计入）
+
+	static size_t _max_load(size_t cap) { return cap - cap / 8; }
+	static size_t _cap_for(size_t n)
 	{
-		return _ensure_is<
-			static_cast<json_value_t>(_meta_find_idx<decltype(_data), _t>::value)
-		>();
+		size_t cap = 16;
+		while (_max_load(cap) < n)cap *= 2;
+		return cap;
+	}
+	static uint64_t _hash(_view_t k)
+	{
+		return _sjson_detail::hash_bytes(k.data(), k.size() * sizeof(typename _view_t::value_type), _sjson_detail::hash_seed());
 	}
 
-	class _my_initializer_list
+	iterator _iter(size_t i) { return { _ctrl.get() + i, _ctrl.get() + _cap, _slots + i }; }
+	const_iterator _iter(size_t i)const { return { _ctrl.get() + i, _ctrl.get() + _cap, _slots + i }; }
+
+	/*
+	* 探测：哈希的高位选出起始组，之后按三角数跳过 1, 2, 3, ... 组（组数为 2 的幂时会访问到每一组），
+	* 遇到有空槽的组即可停止
+	*/
+	size_t _find(_view_t key, uint64_t h)const
 	{
-	public:
-	
-		_my_initializer_list(const _basic_json& x) :_data(x) {}
-	
-		/*
-		* {a,b,c} : 这种情况会对每一个元素调用该函数来初始化
-		*  ^
-		*/
-		template <typename _t>
-		_my_initializer_list(const _t& x) : _data(x) {}
-		/*
-		* (a,b,c) 或 {}
-		* ^^^^^^^
-		* 会调用该函数来初始化
-		*/
-		template <typename... _ts>
-		_my_initializer_list(const _ts &...args) : _data(array_t({ _basic_json(args)... })) {}
-	
-		_my_initializer_list(std::initializer_list<_my_initializer_list> x)
+		if (!_cap)return _npos;
+		size_t gmask = _cap / 16 - 1;
+		auto h2 = static_cast<uint8_t>(h & 0x7f);
+		for (size_t g = (h >> 7) & gmask, step = 1;; g = (g + step++) & gmask)
 		{
-			/*
-			* 形如 {{"xxx",...},{"yyy",...},...} 的数据会被视为 object
-			*/
-			bool is_obj = true;
-			for (auto& it : x)
-			{
-				const auto& node = it._data;
-				if ((!node.hold<array_t>()) || node.get<array_t>().size() != 2)
-				{
-					is_obj = false;
-					break;
-				}
-				if (!node.get<array_t>()[0].hold<string_t>())
-				{
-					is_obj = false;
-					break;
-				}
-			}
-			if (is_obj)
-			{
-				_data.assign(object_t());
-				auto& dest = _data.get<object_t>();
-				for (auto& it : x)
-				{
-					dest.insert(
-						{
-							it._data.get<array_t>()[0].get<std::string>(),
-							it._data.get<array_t>()[1]
-						}
-					);
-				}
-				return;
-			}
-			_data.assign(array_t());
-			auto& dest = _data.get<array_t>();
-			for (auto& it : x)
+			const uint8_t* ctrl = _ctrl.get() + g * 16;
+			for (uint32_t m = _sjson_detail::simd::match_byte16(ctrl, h2); m; m &= m - 1)
 			{
-				dest.push_back(it._data);
+				size_t i = g * 16 + std::countr_zero(m);
+				if (_view_t(_slots[i].first) == key)return i;
 			}
+			if (_sjson_detail::simd::match_byte16(ctrl, _empty))return _npos;
 		}
-	
-		_basic_json& data()& { return _data; }
-		const _basic_json& data() const& { return _data; }
-	
-		_basic_json&& data()&& { return std::move(_data); }
-	
-	private:
-		_basic_json _data;
-	};
-
-	void _dump_to(std::string& out, int tabstop, char space, bool ensure_ascii, int deep = 0)const
+	}
+	// 探测序列上第一个空的或已删除的槽
+	size_t _free_slot(uint64_t h)const
 	{
-		bool need_format = tabstop > 0;
-		auto add_tabs = [&tabstop, &space, &out, &deep]()
-		{
-			out += std::string(deep * tabstop, space);
-		};
-		auto dump_string = [&out, &ensure_ascii](const std::string& s)
+		size_t gmask = _cap / 16 - 1;
+		for (size_t g = (h >> 7) & gmask, step = 1;; g = (g + step++) & gmask)
 		{
-			out += '"';
-			if (!ensure_ascii)out += s;
-			else _sjson_detail::escape_to_ascii(s, out);
+			uint32_t m = _sjson_detail::simd::match_high16(_ctrl.get() + g * 16);
+			if (m)return g * 16 + std::countr_zero(m);
+		}
+	}
 
-			out += '"';
-		};
-
-		static constexpr const char delimiter_ch[] = "?,:[]{}";
-
-		using std::to_string;
+	// 插入确定不存在的键
+	template<typename _k, typename... _args>
+	size_t _emplace_new(uint64_t h, _k&& key, _args&&... args)
+	{
+		if (!_growth_left)_rehash(_cap_for(_size + _size / 2 + 1)); // 已删除的槽较多时容量不变
+		size_t i = _free_slot(h);
+		::new (static_cast<void*>(_slots + i)) value_type(
+			std::piecewise_construct,
+			std::forward_as_tuple(std::forward<_k>(key)),
+			std::forward_as_tuple(std::forward<_args>(args)...)
+		);
+		if (_ctrl[i] == _empty)--_growth_left;
+		_ctrl[i] = static_cast<uint8_t>(h & 0x7f);
+		++_size;
+		return i;
+	}
 
-		switch (type())
-		{
-		case json_value_t::array:
+	void _rehash(size_t cap)
+	{
+		std::unique_ptr<uint8_t[]> ctrl(new uint8_t[cap]);
+		std::memset(ctrl.get(), _empty, cap);
+		value_type* slots = std::allocator<value_type>().allocate(cap);
+		ctrl.swap(_ctrl);
+		std::swap(slots, _slots);
+		std::swap(cap, _cap);
+		_growth_left = _max_load(_cap) - _size;
+		for (size_t i = 0; i < cap; ++i)
 		{
-			const auto& arr = get<array_t>();
-
-			out += '[';
-			if (arr.size() == 1 && arr[0].hole_value_type())
-			{
-				arr[0]._dump_to(out, tabstop, space, ensure_ascii, deep);
-			}
-			else if(!arr.empty())
-			{
-				deep++;
-				if (need_format)out += '\n';
-				for (auto it = arr.begin(); it != arr.end(); ++it)
-				{
-					if (it != arr.begin())
-						out += need_format ? ",\n" : ",";
-					add_tabs();
-					it->_dump_to(out, tabstop, space, ensure_ascii, deep);
-				}
-				deep--;
-				if (need_format)
-				{
-					out += '\n';
-					add_tabs();
-				}
-			}
-			out += ']';
-			break;
+			if (ctrl[i] & 0x80)continue;
+			uint64_t h = _hash(slots[i].first);
+			size_t j = _free_slot(h);
+			::new (static_cast<void*>(_slots + j)) value_type(std::move(slots[i]));
+			_ctrl[j] = static_cast<uint8_t>(h & 0x7f);
+			std::destroy_at(slots + i);
 		}
-		case json_value_t::object:
+		if (slots)std::allocator<value_type>().deallocate(slots, cap);
+	}
+
+	void _release()
+	{
+		if (!_slots)return;
+		for (size_t i = 0; i < _cap; ++i)
 		{
-			const auto& obj = get<object_t>();
-			
-			out += '{';
-			if (obj.size() == 1 && obj.begin()->second.hole_value_type())
-			{
-				const auto& it = obj.begin();
-				dump_string(it->first);
+			if (!(_ctrl[i] & 0x80))std::destroy_at(_slots + i);
+		}
+		std::allocator<value_type>().deallocate(_slots, _cap);
+	}
+};
 
-				out += ':';
-				if (need_format)out += ' ';
+template<
+	typename _string_t = std::string,
+	// 后面必须要有 typename ... 之类的东西（用来满足 vector 和 map 的模板参数）否则会导致被其他模板使用时编译失败
+	template<typename _key_t, typename _val_t, typename ...> typename _map_t = std::unordered_map,
+	template<typename _val_t, typename ...> typename _arr_t = std::vector
+>
+class _basic_json :public _sjson_detail::json_alloc_base<_sjson_detail::is_pmr_string<_string_t>::value>
+{
+public:
 
-				it->second._dump_to(out, tabstop, space, ensure_ascii, deep);
-			}
-			else if (!obj.empty())
-			{
-				if (need_format)
-					out += '\n';
-				deep++;
-				for (auto it = obj.begin(); it != obj.end(); ++it)
-				{
-					if (it != obj.begin())
-						out += need_format ? ",\n" : ",";
-					add_tabs();
-					dump_string(it->first);
+	/*
+	* 字符串类型为 std::pmr::basic_string 时（容器也应使用 std::pmr 的，见 pmr_json），
+	* 结点支持 uses-allocator 构造：数组与对象中的元素、operator[] 新建的值都使用容器的内存资源，
+	* 因此整个文档可以放在同一个 monotonic_buffer_resource 中
+	*/
+	static constexpr bool uses_pmr = _sjson_detail::is_pmr_string<_string_t>::value;
 
-					out += ':';
-					if (need_format)out += ' ';
+private:
 
-					it->second._dump_to(out, tabstop, space, ensure_ascii, deep);
-				}
-				deep--;
-				if (need_format)
-				{
-					out += '\n';
-					add_tabs();
-				}
-			}
-			out += '}';
-			break;
-		}
-		case json_value_t::null:out += "null"; break;
-		case json_value_t::boolean:out += (get<bool>() ? "true" : "false"); break;
-		case json_value_t::string:dump_string(get<std::string>()); break;
-		case json_value_t::num_double:
-		{
-			std::stringstream ss;
-			double d = get<double>();
-			ss << std::defaultfloat << d;
-			string_t s = ss.str();
-			s.erase(std::remove(s.begin(), s.end(), '+'), s.end());
-			out += s;
-			break;
-		}
-		case json_value_t::num_i32:out += to_string(get<int>()); break;
-		case json_value_t::num_ui32:out += to_string(get<uint32_t>()); break;
-		case json_value_t::num_i64:out += to_string(get<int64_t>()); break;
-		case json_value_t::num_ui64:out += to_string(get<uint64_t>()); break;
+	using _alloc_base = _sjson_detail::json_alloc_base<uses_pmr>;
 
-		case _json_value_parser_delimiter:
-		{
-			out.push_back(
-				static_cast<string_char_t>(
-					get<_sjson_detail::parser_delimiter>()
-				)
-			);
-		}
+	template <class _list, class _t>
+	struct _meta_find_idx {
+		static constexpr size_t value = -1;
+	};
 
-			break;
-		default:
-			out += "null";
-			break;
+	static constexpr size_t _meta_find_idx_func(const bool* const _Ptr, const size_t _Count,
+		size_t _Idx = 0) {
+
+		for (; _Idx < _Count; ++_Idx) {
+			if (_Ptr[_Idx]) {
+				return _Idx;
+			}
 		}
+		return -1;
 	}
 
+	template <template <class...> class _list, class _first, class... _rest, class _t>
+	struct _meta_find_idx<_list<_first, _rest...>, _t>
+	{
+		static constexpr bool _bools[] = { std::is_same_v<_first, _t>, std::is_same_v<_rest, _t>... };
+		static constexpr size_t value = _meta_find_idx_func(_bools, 1 + sizeof...(_rest));
+	};
 
-};
+	class _my_initializer_list;
 
-namespace _sjson_detail
-{
-	template<typename _json_t>
-	class parser
-	{
-	private:
+public:
 
-		using _error = json_parse_error;
-		using _origin = json_error_origin;
+	using string_t = _string_t;
+	using string_char_t = typename _string_t::value_type;
 
-		using _char_t = _json_t::string_char_t;
-		using _str_t = _json_t::string_t;
+	using array_t = _arr_t<_basic_json>;
+	using object_t = _map_t<string_t, _basic_json>;
+	using raw_number_t = basic_raw_number<string_t>;
 
-	public:
+private:
 
-		static constexpr _char_t end_flag = 0;
-		using get_f = std::function<_char_t()>;
+	std::variant<
+		array_t, object_t,
+		nullptr_t, double, int32_t, bool,
+		string_t,
+		uint32_t, int64_t, uint64_t,
 
-	private:
+		_sjson_detail::parser_delimiter,
+		raw_number_t
+	> _data;
 
-		_char_t _cur_ch;
-		_char_t _next_ch;
-		get_f _getch_func;
+	// 原样保存的数字可以转换为的类型
+	template<typename _t>
+	static constexpr bool _is_number_v =
+		std::is_same_v<_t, double> || std::is_same_v<_t, int32_t> || std::is_same_v<_t, uint32_t>
+		|| std::is_same_v<_t, int64_t> || std::is_same_v<_t, uint64_t>;
 
-		struct
-		{
-			uint32_t line = 0, column = 0;
-		}_cur_pos, _cur_node_start_pos;
+	static constexpr json_value_t _json_value_parser_delimiter = static_cast<json_value_t>(10);
 
+	template<typename _t>
+	using _enable_if_can_assign = typename std::enable_if<
+		!std::is_same<_t, decltype(_data)>::value &&
+		std::is_constructible<decltype(_data), _t>::value,
+	int>::type;
 
-		_json_t _cur_node;
+	size_t _type_raw() const { return _data.index(); }
 
-		bool _is_abort = false;
-		json_parse_error_callback_f _err_callback;
+public:
+		
+	/**
+	 * @brief 初始化为一个空的 json
+	*/
+	_basic_json() :_data(nullptr) {}
 
-		void _throw_err(
-			json_error_origin origin,
-			json_parse_error e, const std::string& msg = ""
-		)
-		{
-			if (_err_callback)
-			{
-				if (
-					_err_callback(
-						_cur_node_start_pos.line,
-						_cur_node_start_pos.column,
-						origin, e, msg
-					) == json_callback_ret::abort
-					) {
-					_cur_ch = _next_ch = end_flag;
-					_is_abort = true;
-				}
-			}
-		}
+	/**
+	 * @brief 使用内存资源 a 构造（仅 uses_pmr），其余参数同其他构造函数；
+	 *        参数为 json 时复制（资源相同且为右值时移动）到 a 中
+	*/
+	template<
+		typename _alloc_t, typename... _args,
+		std::enable_if_t<std::is_convertible_v<const _alloc_t&, std::pmr::polymorphic_allocator<std::byte>>, int> = 0
+	>
+	_basic_json(std::allocator_arg_t, const _alloc_t& a, _args&&... args)
+		:_alloc_base(std::pmr::polymorphic_allocator<std::byte>(a).resource()), _data(nullptr)
+	{
+		static_assert(uses_pmr, "only pmr json takes a memory resource");
+		if constexpr (sizeof...(_args) == 1 && (std::is_same_v<std::decay_t<_args>, json_value_t> && ...))_assign_type(args...);
+		else if constexpr (sizeof...(_args) == 1)assign(std::forward<_args>(args)...);
+		else if constexpr (sizeof...(_args) != 0)assign(_basic_json(std::forward<_args>(args)...));
+	}
+	template<
+		typename _alloc_t,
+		std::enable_if_t<std::is_convertible_v<const _alloc_t&, std::pmr::polymorphic_allocator<std::byte>>, int> = 0
+	>
+	_basic_json(std::allocator_arg_t, const _alloc_t& a, const std::initializer_list<_my_initializer_list>& x)
+		:_basic_json(std::allocator_arg, a)
+	{
+		assign(_my_initializer_list(x).data());
+	}
+		
+	/**
+	 * @brief 使用 x 初始化 json
+	 * @tparam _t 可接受的数据类型（详见 json_value_t）
+	 * @param x 用于初始化的值
+	*/
+	template <typename _t, _enable_if_can_assign<_t> = 0>
+	_basic_json(const _t& x) { assign(x); }
 
-		constexpr static bool _isdigit(_char_t ch, int base = 10)
-		{
-			return ('0' <= ch && ch <= '9')
-				|| ('A' <= ch && ch < 'A' + (base -= 10))
-				|| ('a' <= ch && ch < 'a' + base);
-		}
-		constexpr static bool _isalpha(_char_t ch)
-		{
-			return ('a' <= ch && ch <= 'z') || ('A' <= ch && ch <= 'Z');
-		}
-		constexpr static bool _isalnum(_char_t ch, int base = 10)
-		{
-			return _isalpha(ch) || _isdigit(ch, base);
-		}
+	_basic_json(const _basic_json&) = default;
+	_basic_json(_basic_json&&) = default;
 
-		_char_t _look_nextch()const { return _next_ch; }
-		void _get_nextch()
-		{
-			if (_is_abort)return;
-			_cur_ch = _next_ch;
-			_next_ch = _getch_func();
-			if (_cur_ch == '\n')
-			{
-				_cur_pos.line++;
-				_cur_pos.column = 0;
-			}
-			else _cur_pos.column++;
-		}
-		bool _match_ch(_char_t want)
-		{
-			return _look_nextch() == want ? _get_nextch(), true : false;
-		}
+	// 移动构造，不复制字符串、数组或对象（pmr 时使用 x 的内存资源）
+	_basic_json(string_t&& x) :_data(std::move(x)) { _adopt_resource<string_t>(); }
+	_basic_json(array_t&& x) :_data(std::move(x)) { _adopt_resource<array_t>(); }
+	_basic_json(object_t&& x) :_data(std::move(x)) { _adopt_resource<object_t>(); }
+	_basic_json(raw_number_t&& x) :_data(std::move(x)) { _adopt_resource<raw_number_t>(); }
 
-		inline bool _is_end()const { return !bool(_cur_ch); }
+	_basic_json(const std::initializer_list<_my_initializer_list>& x)
+	{
+		assign(_my_initializer_list(x).data());
+	}
 
-		void _skip_space()
-		{
-			while (isspace(_cur_ch))
-			{
-				_get_nextch();
-			}
-		}
-		void _skip_line()
-		{
-			while (_cur_ch != end_flag)
-			{
-				if (_cur_ch == '\n')
-				{
-					_get_nextch();
-					break;
-				}
-				_get_nextch();
-			}
-		}
-		void _skip_comment()
-		{
-			if (_match_ch('/')) // 单行注释
-			{
-				_skip_line();
-			}
-			else if (_match_ch('*'))
-			{
+	_basic_json(json_value_t t)
+	{
+		_assign_type(t);
+	}
+
+	json_value_t type()const { return static_cast<json_value_t>(_type_raw()); }
+	
+	const char* type_name()const { return json_type_name(type()); }
+	const char* value_t_name()const { return json_value_t_name(type()); }
+
+
+	/**
+	 * @brief 清空当前的数据（设为 nullptr）
+	*/
+	void clear() { _data = nullptr; }
+
+	// assign
+	#pragma region assign
+
+	/**
+	 * @brief 初始化为空
+	*/
+	void assign() { clear(); }
+	
+	/**
+	 * @brief 通过 可被接受的数据 构造
+	 * @tparam _t 可接受的数据类型（详见 json_value_t）
+	 * @param x 可接受的数据
+	*/
+	template <typename _t, _enable_if_can_assign<_t> = 0>
+	void assign(const _t& x)
+	{
+		if constexpr (uses_pmr)
+		{
+			if constexpr (std::is_same_v<_t, string_t> || std::is_same_v<_t, array_t> || std::is_same_v<_t, object_t>)
+				_data = _t(x, this->get_allocator()); // 复制到本结点的内存资源中
+			else if constexpr (std::is_same_v<_t, raw_number_t>)
+				_data = raw_number_t{ string_t(x.text, this->get_allocator()), x.integral, x.fits_int64 };
+			else _data = x;
+		}
+		else _data = x;
+	}
+	
+	/**
+	 * @brief 通过 字符指针/数组 构造
+	 * @param str 字符串
+	*/
+	void assign(const string_char_t* str) // 防止 char* 被当成 bool 错误调用
+	{
+		_data = _make<string_t>(str);
+	}
+
+	/**
+	 * @brief 通过 另一个 json 值 构造
+	 * @param x 指定的 json
+	*/
+	void assign(const _basic_json& x)
+	{
+		if constexpr (uses_pmr)_copy_from(x);
+		else _data = x._data;
+	}
+	/**
+	 * @brief 从 另一个 json 值 移动
+	 * @param x 指定的 json（之后其内容不确定）
+	 *        pmr 时两者的内存资源不同则复制到本结点的资源中
+	*/
+	void assign(_basic_json&& x)
+	{
+		if constexpr (uses_pmr)
+		{
+			// x 不持有内存或资源相同（此时 std::pmr 容器的移动赋值直接接管内存）时直接移动
+			if (!x._holds_memory() || *this->_res == *x._res)_data = std::move(x._data);
+			else _copy_from(x);
+		}
+		else _data = std::move(x._data);
+	}
+
+	#pragma endregion
+
+	const _basic_json& operator=(const _basic_json& x)
+	{
+		assign(x);
+		return x;
+	}
+	// pmr 时同 assign：结点保留自己的内存资源，与 x 的不同时复制
+	_basic_json& operator=(_basic_json&& x) noexcept(!uses_pmr)
+	{
+		if constexpr (uses_pmr)assign(std::move(x));
+		else _data = std::move(x._data);
+		return *this;
+	}
+
+	// hold
+
+	/**
+	 * @brief 检查持有类型是否为 _t
+	 * @tparam _t 要检查的类型
+	 * @return 是否持有
+	*/
+	template<typename _t>
+	bool hold()const noexcept { return std::holds_alternative<_t>(_data); }
+	
+	/**
+	 * @brief 检查持有类型的编号是否为 _idx
+	 * @return 是否持有
+	*/
+	template<json_value_t _idx>
+	bool hold()const noexcept
+	{
+		return hold<
+			std::variant_alternative_t<
+				static_cast<size_t>(_idx), decltype(_data)
+			>
+		>();
+	}
+
+	/**
+	 * @brief 检查是否持有 值 类型
+	 * @return 是否持有
+	 */
+	bool hole_value_type()const noexcept
+	{
+		auto t = type();
+		if (t == json_value_t::array
+			|| t == json_value_t::object
+			|| t == _json_value_parser_delimiter
+			)return false;
+		return true;
+	}
+
+	// get
+	#pragma region get
+
+#define _TYPE_OF_IDX std::variant_alternative_t<static_cast<size_t>(_idx), decltype(_data)>
+
+	/**
+	 * @brief 尝试获取指定类型数据
+	 * @tparam _t 类型
+	 * @return 指向目标数据的指针，如持有类型非 _t 则返回空指针
+	*/
+	template<typename _t>
+	_t* get_if() { return std::get_if<_t>(&_data); }
+	/**
+	 * @brief 尝试获取指定类型数据
+	 * @tparam _t 类型
+	 * @return 指向目标数据的指针，如持有类型非 _t 则返回空指针
+	*/
+	template<typename _t>
+	const _t* get_if()const { return std::get_if<_t>(&_data); }
+	/**
+	 * @brief 尝试获取指定类型数据
+	 * @tparam _idx 类型的编号
+	 * @return 指向目标数据的指针，如持有类型非 _idx 所对应则返回空指针
+	*/
+	template<json_value_t _idx>
+	_TYPE_OF_IDX* get_if() { return std::get_if<static_cast<size_t>(_idx)>(&_data); }
+	/**
+	 * @brief 尝试获取指定类型数据
+	 * @tparam _idx 类型的编号
+	 * @return 指向目标数据的指针，如持有类型非 _idx 所对应则返回空指针
+	*/
+	template<json_value_t _idx>
+	const _TYPE_OF_IDX* get_if()const { return std::get_if<static_cast<size_t>(_idx)>(&_data); }
+
+	// get<_t>
+
+	/**
+	 * @brief 获取指定类型数据
+	 * @tparam _t 类型
+	 * @return 目标数据，如持有类型非 _t 则将当前值调整为 _t 后返回。（定义 _SJSON_DISABLE_AUTO_TYPE_ADJUST 则会抛出错误代替调整）
+	 *         数字类型按值返回（修改数字请直接给 json 赋值）；原样保存的数字与 const 版本一样返回转换结果，
+	 *         不被替换，之后 dump 仍输出原文
+	*/
+	template<typename _t>
+	std::conditional_t<_is_number_v<_t>, _t, _t&> get()
+	{
+		if constexpr (_is_number_v<_t>)
+		{
+			if (hold<raw_number_t>())
+			{
+				const _basic_json& self = *this;
+				return self.get<_t>();
+			}
+		}
+		_JSON_ENSURE_IS(_t);
+		return std::get<_t>(_data);
+	}
+	/**
+	 * @brief 获取指定类型数据
+	 * @tparam _t 类型
+	 * @return 目标数据，如持有类型非 _t 则返回一个静态常量值的引用。（定义 _SJSON_DISABLE_AUTO_TYPE_ADJUST 则会抛出错误）
+	 *         数字类型按值返回：原样保存的数字能转换为 _t 时返回转换结果，每次读取都重新转换，
+	 *         不修改 json（同一个 json 可以在多个线程中同时读取）
+	*/
+	template<typename _t>
+	std::conditional_t<_is_number_v<_t>, _t, const _t&> get()const
+	{
+		if constexpr (_is_number_v<_t>)
+		{
+			if (auto* r = get_if<raw_number_t>())
+			{
+				_t v;
+				if (_sjson_detail::raw_number_get(*r, v))return v;
+			}
+		}
+		_JSON_ENSURE_IS(_t);
+		return hold<_t>() ? std::get<_t>(_data) : _make_tmp<_t>();
+	}
+
+	// get<_idx>
+
+	/**
+	 * @brief 获取指定类型数据
+	 * @tparam _idx 类型的序号
+	 * @return 目标数据，如持有类型非 _t 则将当前值调整为 _idx 所对应类型后返回。（定义 _SJSON_DISABLE_AUTO_TYPE_ADJUST 则会抛出错误代替调整）
+	*/
+	template<json_value_t _idx>
+	inline decltype(auto) get()
+	{
+		return get<_TYPE_OF_IDX>();
+	}
+	/**
+	 * @brief 获取指定类型数据
+	 * @tparam _idx 类型的序号
+	 * @return 目标数据，如持有类型非 _idx 所对应类型则返回一个静态常量值的引用。（定义 _SJSON_DISABLE_AUTO_TYPE_ADJUST 则会抛出错误）
+	*/
+	template<json_value_t _idx>
+	inline decltype(auto) get()const
+	{
+		return get<_TYPE_OF_IDX>();
+	}
+
+#undef _TYPE_OF_IDX
+
+	#pragma endregion
+
+	#pragma region operator
+
+	// operator ==
+
+	bool operator == (const _basic_json& j)const
+	{
+		return _data == j._data;
+	}
+	template <typename _t, _enable_if_can_assign<_t> = 0>
+	bool operator == (const _t& val)const
+	{
+		return _data == _basic_json(val)._data;
+	}
+
+	// operator _t
+
+	inline operator const array_t& () const { return get<array_t>(); }
+	inline operator const object_t& () const { return get<object_t>(); }
+	template <
+		typename _t,
+		typename std::enable_if_t<
+		!(
+			// 消除 string 歧义
+			std::is_pointer_v<_t> // [const] char* [const]
+			|| std::is_same_v<_t, string_char_t>
+			|| std::is_same_v<_t, std::initializer_list<string_char_t> >
+			), int
+		> = 0
+	> inline operator _t () const { return get<_t>(); }
+
+	// operator []
+	
+	// 如果超出数组范围，会更改大小
+	_basic_json& operator[](size_t idx)
+	{
+		_JSON_TRY(get<array_t>());
+		auto& arr = get<array_t>();
+		if (idx >= arr.size())arr.resize(idx + 1);
+		return arr[idx];
+	}
+	const _basic_json& operator[](size_t idx)const
+	{
+		_JSON_TRY(return get<array_t>()[idx]);
+	}
+
+	_basic_json& operator[](const string_t& key)
+	{
+		_JSON_TRY(return get<object_t>()[key]);
+	}
+	const _basic_json& operator[](const string_t& key)const
+	{
+		_JSON_TRY(get<object_t>());
+		const auto& obj = get<object_t>();
+		const auto& it = obj.find(key);
+		return (it == obj.end()) ? _make_tmp<_basic_json>() : it->second;
+	}
+
+	// 不使用 string_char_t* 以防 0 被错误识别
+
+	template <typename _t>
+	_basic_json& operator[](const _t* const key)
+	{
+		return this->operator[](std::move(string_t(key)));
+	}
+	template <typename _t>
+	const _basic_json& operator[](const _t* const key)const
+	{
+		return this->operator[](std::move(string_t(key)));
+	}
+
+#pragma endregion
+
+	/**
+	 * \param out 用于存放格式化后的字符串
+	 * \param tabstop 缩进长度
+	 * \param space 缩进字符
+	 * \param ensure_ascii 是否需要转换成 ASCII 格式（字符串会被强行当成 UTF-8 格式处理）
+	 */
+	void dump_to(std::string& out, int tabstop = -1, char space = ' ', bool ensure_ascii = true)const
+	{
+		if (tabstop < 0)tabstop = 4;
+		_dump_to(out, tabstop, space, ensure_ascii);
+	}
+	/** 
+	 * \param tabstop 缩进长度
+	 * \param space 缩进字符
+	 * \param ensure_ascii 是否需要转换成 ASCII 格式（字符串会被强行当成 UTF-8 格式处理）
+	 * \return 格式化结果
+	 */
+	std::string dump(int tabstop = -1, char space = ' ', bool ensure_ascii = true)const
+	{
+		std::string res;
+		dump_to(res, tabstop, space, ensure_ascii);
+		return res;
+	}
+
+	friend std::istream& operator>>(std::istream& is, _basic_json& j)
+	{
+		_sjson_detail::parser<_basic_json>(is).get_result_to(j);
+		return is;
+	}
+
+	void push_back(const _basic_json& j)
+	{
+		if (hold<array_t>())get<array_t>().push_back(j);
+		else
+		{
+
+		}
+	}
+	void push_back(_basic_json&& j)
+	{
+		if (hold<array_t>())get<array_t>().push_back(std::move(j));
+	}
+
+	size_t size()
+	{
+		if (hold<array_t>())return get<array_t>().size();
+		else if (hold<object_t>())return get<object_t>().size();
+		// TOOD 抛出错误不能对值使用 size()
+		return 0;
+	}
+
+	/**
+	 * @brief 交换两个 json 的内容。与赋值相同，pmr 的 json 各自保持自己的内存资源：
+	 *        资源不同时双方各自把对方的内容复制到自己的资源中（可能抛出异常，此时两者都不变）
+	*/
+	void swap(_basic_json& x)noexcept(!uses_pmr)
+	{
+		if constexpr (uses_pmr)
+		{
+			if (*this->_res != *x._res)
+			{
+				_basic_json mine(std::allocator_arg, this->get_allocator(), std::as_const(x));
+				_basic_json theirs(std::allocator_arg, x.get_allocator(), std::as_const(*this));
+				// 资源相同，移动不再分配
+				_data = std::move(mine._data);
+				x._data = std::move(theirs._data);
+			}
+			else _data.swap(x._data);
+		}
+		else _data.swap(x._data);
+	}
+
+private:
+
+	// 新建 _t，pmr 时字符串与容器使用本结点的内存资源
+	template<typename _t, typename... _args>
+	_t _make(_args&&... args)const
+	{
+		if constexpr (uses_pmr && std::uses_allocator_v<_t, std::pmr::polymorphic_allocator<std::byte>>)
+			return _t(std::forward<_args>(args)..., this->get_allocator());
+		else return _t(std::forward<_args>(args)...);
+	}
+
+	void _assign_type(json_value_t t)
+	{
+		switch (t)
+		{
+		case json_value_t::array: _data = _make<array_t>(); break;
+		case json_value_t::object: _data = _make<object_t>(); break;
+		case json_value_t::null: assign(nullptr); break;
+		case json_value_t::num_double: assign(0.0); break;
+		case json_value_t::num_i32: assign(0); break;
+		case json_value_t::boolean: assign(false); break;
+		case json_value_t::string: _data = _make<string_t>(); break;
+		case json_value_t::num_ui32: assign(0U); break;
+		case json_value_t::num_i64: assign(0LL); break;
+		case json_value_t::num_ui64:assign(0ULL); break;
+		default:
+			break;
+		}
+	}
+
+	bool _holds_memory()const
+	{
+		return hold<string_t>() || hold<array_t>() || hold<object_t>() || hold<raw_number_t>();
+	}
+
+	template<typename _t>
+	void _adopt_resource()
+	{
+		if constexpr (uses_pmr && std::is_same_v<_t, raw_number_t>)this->_res = std::get<_t>(_data).text.get_allocator().resource();
+		else if constexpr (uses_pmr)this->_res = std::get<_t>(_data).get_allocator().resource();
+	}
+
+	// 把 x 复制到本结点的内存资源中（仅 uses_pmr），元素经 uses-allocator 构造递归地复制
+	void _copy_from(const _basic_json& x)
+	{
+		auto a = this->get_allocator();
+		if (auto* s = x.get_if<string_t>())_data = string_t(*s, a);
+		else if (auto* arr = x.get_if<array_t>())_data = array_t(*arr, a);
+		else if (auto* obj = x.get_if<object_t>())_data = object_t(*obj, a);
+		else if (auto* r = x.get_if<raw_number_t>())assign(*r);
+		else _data = x._data;
+	}
+
+	template<typename _t>
+	static inline const _t& _make_tmp()
+	{
+		static const _t tmp = _t();
+		return tmp;
+	}
+
+	template<json_value_t _idx>
+	bool _ensure_is()
+	{
+		using _t = std::variant_alternative_t<static_cast<size_t>(_idx), decltype(_data)>;
+		if (!hold<_t>())
+		{
+			if (!hold<nullptr_t>())
+			{
+				_JSON_THROW_TYPE_ADJUST(type(), _idx);
+			}
+			_data = _make<_t>();
+		}
+		return true;
+	}
+	template<typename _t>
+	bool _ensure_is()
+	{
+		return _ensure_is<
+			static_cast<json_value_t>(_meta_find_idx<decltype(_data), _t>::value)
+		>();
+	}
+
+	template<json_value_t _idx>
+	bool _ensure_is()const
+	{
+		if (!hold<_idx>())
+		{
+			if (hold<nullptr_t>())return false;
+			_JSON_THROW_TYPE_ADJUST(type(), _idx);
+			// 如果没有定义 _SJSON_DISABLE_AUTO_TYPE_ADJUST 则该语句无效，会在调用 get 处调整
+		}
+		return true;
+	}
+	template<typename _t>
+	bool _ensure_is()const
+	{
+		return _ensure_is<
+			static_cast<json_value_t>(_meta_find_idx<decltype(_data), _t>::value)
+		>();
+	}
+
+	class _my_initializer_list
+	{
+	public:
+	
+		_my_initializer_list(const _basic_json& x) :_data(x) {}
+	
+		/*
+		* {a,b,c} : 这种情况会对每一个元素调用该函数来初始化
+		*  ^
+		*/
+		template <typename _t>
+		_my_initializer_list(const _t& x) : _data(x) {}
+		/*
+		* (a,b,c) 或 {}
+		* ^^^^^^^
+		* 会调用该函数来初始化
+		*/
+		template <typename... _ts>
+		_my_initializer_list(const _ts &...args) : _data(array_t({ _basic_json(args)... })) {}
+	
+		_my_initializer_list(std::initializer_list<_my_initializer_list> x)
+		{
+			/*
+			* 形如 {{"xxx",...},{"yyy",...},...} 的数据会被视为 object
+			*/
+			bool is_obj = true;
+			for (auto& it : x)
+			{
+				const auto& node = it._data;
+				if ((!node.hold<array_t>()) || node.get<array_t>().size() != 2)
+				{
+					is_obj = false;
+					break;
+				}
+				if (!node.get<array_t>()[0].hold<string_t>())
+				{
+					is_obj = false;
+					break;
+				}
+			}
+			if (is_obj)
+			{
+				_data.assign(object_t());
+				auto& dest = _data.get<object_t>();
+				for (auto& it : x)
+				{
+					dest.insert(
+						{
+							it._data.get<array_t>()[0].get<string_t>(),
+							it._data.get<array_t>()[1]
+						}
+					);
+				}
+				return;
+			}
+			_data.assign(array_t());
+			auto& dest = _data.get<array_t>();
+			for (auto& it : x)
+			{
+				dest.push_back(it._data);
+			}
+		}
+	
+		_basic_json& data()& { return _data; }
+		const _basic_json& data() const& { return _data; }
+	
+		_basic_json&& data()&& { return std::move(_data); }
+	
+	private:
+		_basic_json _data;
+	};
+
+	void _dump_to(std::string& out, int tabstop, char space, bool ensure_ascii, int deep = 0)const
+	{
+		bool need_format = tabstop > 0;
+		auto add_tabs = [&tabstop, &space, &out, &deep]()
+		{
+			out += std::string(deep * tabstop, space);
+		};
+		auto dump_string = [&out, &ensure_ascii](const string_t& s)
+		{
+			out += '"';
+			if (!ensure_ascii)out += s;
+			else _sjson_detail::escape_to_ascii(s, out);
+
+			out += '"';
+		};
+
+		static constexpr const char delimiter_ch[] = "?,:[]{}";
+
+		using std::to_string;
+
+		switch (type())
+		{
+		case json_value_t::array:
+		{
+			const auto& arr = get<array_t>();
+
+			out += '[';
+			if (arr.size() == 1 && arr[0].hole_value_type())
+			{
+				arr[0]._dump_to(out, tabstop, space, ensure_ascii, deep);
+			}
+			else if(!arr.empty())
+			{
+				deep++;
+				if (need_format)out += '\n';
+				for (auto it = arr.begin(); it != arr.end(); ++it)
+				{
+					if (it != arr.begin())
+						out += need_format ? ",\n" : ",";
+					add_tabs();
+					it->_dump_to(out, tabstop, space, ensure_ascii, deep);
+				}
+				deep--;
+				if (need_format)
+				{
+					out += '\n';
+					add_tabs();
+				}
+			}
+			out += ']';
+			break;
+		}
+		case json_value_t::object:
+		{
+			const auto& obj = get<object_t>();
+			
+			out += '{';
+			if (obj.size() == 1 && obj.begin()->second.hole_value_type())
+			{
+				const auto& it = obj.begin();
+				dump_string(it->first);
+
+				out += ':';
+				if (need_format)out += ' ';
+
+				it->second._dump_to(out, tabstop, space, ensure_ascii, deep);
+			}
+			else if (!obj.empty())
+			{
+				if (need_format)
+					out += '\n';
+				deep++;
+				for (auto it = obj.begin(); it != obj.end(); ++it)
+				{
+					if (it != obj.begin())
+						out += need_format ? ",\n" : ",";
+					add_tabs();
+					dump_string(it->first);
+
+					out += ':';
+					if (need_format)out += ' ';
+
+					it->second._dump_to(out, tabstop, space, ensure_ascii, deep);
+				}
+				deep--;
+				if (need_format)
+				{
+					out += '\n';
+					add_tabs();
+				}
+			}
+			out += '}';
+			break;
+		}
+		case json_value_t::null:out += "null"; break;
+		case json_value_t::boolean:out += (get<bool>() ? "true" : "false"); break;
+		case json_value_t::string:dump_string(get<string_t>()); break;
+		case json_value_t::num_double:_sjson_detail::dump_double_to(get<double>(), out); break;
+		case json_value_t::num_i32:out += to_string(get<int>()); break;
+		case json_value_t::num_ui32:out += to_string(get<uint32_t>()); break;
+		case json_value_t::num_i64:out += to_string(get<int64_t>()); break;
+		case json_value_t::num_ui64:out += to_string(get<uint64_t>()); break;
+		case json_value_t::num_raw:
+		{
+			const auto& text = get<raw_number_t>().text;
+			out.append(text.begin(), text.end());
+			break;
+		}
+
+		case _json_value_parser_delimiter:
+		{
+			out.push_back(
+				static_cast<string_char_t>(
+					get<_sjson_detail::parser_delimiter>()
+				)
+			);
+		}
+
+			break;
+		default:
+			out += "null";
+			break;
+		}
+	}
+
+
+};
+
+template<typename _json_t>
+class _basic_lazy_document;
+
+/*
+* 字符串池：内容相同的字符串只保存一份，intern 返回指向池内存储的 string_view
+* （在 clear 或池销毁之前一直有效）
+* 可以在多个解析器之间共享，用来合并大量重复的键与枚举类的值；不是线程安全的
+*/
+template<typename _char_t = char>
+class basic_string_pool
+{
+public:
+
+	using view_t = std::basic_string_view<_char_t>;
+
+private:
+
+	struct _hash
+	{
+		using is_transparent = void;
+		size_t operator()(view_t s)const { return std::hash<view_t>()(s); }
+	};
+
+	std::unordered_set<std::basic_string<_char_t>, _hash, std::equal_to<>> _strs;
+	size_t _hits = 0;
+	size_t _stored_bytes = 0;
+	size_t _saved_bytes = 0;
+
+public:
+
+	/**
+	 * @brief 取得与 s 内容相同的池内字符串，不存在时加入
+	 */
+	view_t intern(view_t s)
+	{
+		auto it = _strs.find(s);
+		if (it != _strs.end())
+		{
+			++_hits;
+			_saved_bytes += s.size() * sizeof(_char_t);
+			return *it;
+		}
+		_stored_bytes += s.size() * sizeof(_char_t);
+		return *_strs.emplace(s).first;
+	}
+
+	// 池中不同字符串的个数（即未命中的次数）
+	size_t size()const { return _strs.size(); }
+	size_t hits()const { return _hits; }
+	size_t lookups()const { return _hits + _strs.size(); }
+	double hit_rate()const { return lookups() ? static_cast<double>(_hits) / lookups() : 0; }
+	// 池中保存的字符数据大小（字节）
+	size_t stored_bytes()const { return _stored_bytes; }
+	// 命中而无需再保存的字符数据大小（字节）
+	size_t saved_bytes()const { return _saved_bytes; }
+
+	void clear()
+	{
+		_strs.clear();
+		_hits = _stored_bytes = _saved_bytes = 0;
+	}
+};
+
+using string_pool = basic_string_pool<>;
+
+/*
+* 把整个文件映射到内存（带顺序访问提示），析构时解除映射
+* 以 copy_on_write 打开时映射可写，写入只影响本进程的副本而不会写回文件（用于原地解析）
+* 定义 _SJSON_DISABLE_MMAP 时改为一次读入内存；打开失败时抛出 json_error
+*/
+class mapped_file
+{
+public:
+
+	mapped_file() = default;
+	explicit mapped_file(const std::string& path, bool copy_on_write = false)
+	{
+		_open(path, copy_on_write);
+	}
+
+	mapped_file(const mapped_file&) = delete;
+	mapped_file& operator=(const mapped_file&) = delete;
+	mapped_file(mapped_file&& x) noexcept
+	{
+		_swap(x);
+	}
+	mapped_file& operator=(mapped_file&& x) noexcept
+	{
+		if (this != &x)
+		{
+			close();
+			_swap(x);
+		}
+		return *this;
+	}
+	~mapped_file() { close(); }
+
+	char* data() { return _data; }
+	const char* data()const { return _data; }
+	size_t size()const { return _size; }
+	std::string_view view()const { return { _data, _size }; }
+	// 能否写入（以 copy_on_write 打开）
+	bool writable()const { return _writable; }
+
+	void close()
+	{
+#if defined(_SJSON_DISABLE_MMAP)
+		_buf = std::vector<char>();
+#elif defined(_WIN32)
+		if (_data)UnmapViewOfFile(_data);
+#else
+		if (_data)::munmap(_data, _size);
+#endif
+		_data = nullptr;
+		_size = 0;
+		_writable = false;
+	}
+
+private:
+
+	char* _data = nullptr;
+	size_t _size = 0;
+	bool _writable = false;
+#if defined(_SJSON_DISABLE_MMAP)
+	std::vector<char> _buf;
+#endif
+
+	void _swap(mapped_file& x) noexcept
+	{
+		std::swap(_data, x._data);
+		std::swap(_size, x._size);
+		std::swap(_writable, x._writable);
+#if defined(_SJSON_DISABLE_MMAP)
+		_buf.swap(x._buf);
+#endif
+	}
+
+	void _open(const std::string& path, bool copy_on_write)
+	{
+#if defined(_SJSON_DISABLE_MMAP)
+		std::ifstream is(path, std::ios::binary);
+		if (!is)_JSON_THROW("cannot open file: " + path, 0);
+		is.seekg(0, std::ios::end);
+		std::streamoff size = is.tellg();
+		// 不能定位的文件（如管道）tellg 返回 -1
+		if (size < 0)_JSON_THROW("cannot read file: " + path, 0);
+		_buf.resize(static_cast<size_t>(size));
+		is.seekg(0, std::ios::beg);
+		is.read(_buf.data(), _buf.size());
+		if (!is)_JSON_THROW("cannot read file: " + path, 0);
+		_data = _buf.data();
+		_size = _buf.size();
+		_writable = true;
+#elif defined(_WIN32)
+		HANDLE file = CreateFileA(
+			path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+			OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr
+		);
+		if (file == INVALID_HANDLE_VALUE)_JSON_THROW("cannot open file: " + path, 0);
+		LARGE_INTEGER n;
+		if (!GetFileSizeEx(file, &n) || static_cast<uint64_t>(n.QuadPart) > SIZE_MAX)
+		{
+			CloseHandle(file);
+			_JSON_THROW("cannot map file: " + path, 0);
+		}
+		_size = static_cast<size_t>(n.QuadPart);
+		if (_size)
+		{
+			// 映射与视图各自持有对文件与映射对象的引用，句柄可以立即关闭
+			HANDLE mapping = CreateFileMappingA(file, nullptr, copy_on_write ? PAGE_WRITECOPY : PAGE_READONLY, 0, 0, nullptr);
+			CloseHandle(file);
+			void* p = mapping ? MapViewOfFile(mapping, copy_on_write ? FILE_MAP_COPY : FILE_MAP_READ, 0, 0, 0) : nullptr;
+			if (mapping)CloseHandle(mapping);
+			if (!p)
+			{
+				_size = 0;
+				_JSON_THROW("cannot map file: " + path, 0);
+			}
+			_data = static_cast<char*>(p);
+		}
+		else CloseHandle(file);
+		_writable = copy_on_write;
+#else
+		int fd = ::open(path.c_str(), O_RDONLY);
+		if (fd < 0)_JSON_THROW("cannot open file: " + path, 0);
+		struct stat st;
+		if (::fstat(fd, &st) != 0 || static_cast<uint64_t>(st.st_size) > SIZE_MAX)
+		{
+			::close(fd);
+			_JSON_THROW("cannot map file: " + path, 0);
+		}
+		_size = static_cast<size_t>(st.st_size);
+		if (_size)
+		{
+			// 关闭文件描述符不影响已建立的映射
+			void* p = ::mmap(nullptr, _size, copy_on_write ? PROT_READ | PROT_WRITE : PROT_READ, MAP_PRIVATE, fd, 0);
+			::close(fd);
+			if (p == MAP_FAILED)
+			{
+				_size = 0;
+				_JSON_THROW("cannot map file: " + path, 0);
+			}
+			::posix_madvise(p, _size, POSIX_MADV_SEQUENTIAL);
+			_data = static_cast<char*>(p);
+		}
+		else ::close(fd);
+		_writable = copy_on_write;
+#endif
+	}
+};
+
+#pragma region BIND
+
+/*
+* 结构体绑定：在结构体所在的命名空间中使用
+*   SJSON_BIND(type, member1, member2, ...)
+* 声明参与读写的成员（以成员名为键），之后即可用 parse_into 直接把 json 读入结构体，
+* 用 dump_bound 直接把结构体写成 json，中间不构建 json 树
+* 成员可以是 bool、数字、std::string、json、已绑定的结构体以及它们的 std::vector、std::optional
+* std::string_view 成员只能用原地解析（parse_into_in_place）读取，否则解析结束后会悬空
+* 数字超出成员类型的范围、或把小数读入整数成员时报告 bind_value 错误，成员保持不变
+* 最多 32 个成员
+*/
+
+// MSVC 的传统预处理器会把 __VA_ARGS__ 当作一个参数传递，需要再展开一次
+#define _SJSON_EXPAND(x) x
+#define _SJSON_NARG(...) _SJSON_EXPAND(_SJSON_NARG_N(__VA_ARGS__, \
+	32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17, \
+	16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1))
+#define _SJSON_NARG_N( \
+	_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, _14, _15, _16, \
+	_17, _18, _19, _20, _21, _22, _23, _24, _25, _26, _27, _28, _29, _30, _31, _32, n, ...) n
+#define _SJSON_CONCAT(a, b) _SJSON_CONCAT_IMPL(a, b)
+#define _SJSON_CONCAT_IMPL(a, b) a##b
+
+// 对每个参数 x 展开 m(x)，以 ',' 分隔
+#define _SJSON_FOR_EACH(m, ...) _SJSON_EXPAND(_SJSON_CONCAT(_SJSON_FOR_EACH_, _SJSON_NARG(__VA_ARGS__))(m, __VA_ARGS__))
+#define _SJSON_FOR_EACH_1(m, x) m(x)
+#define _SJSON_FOR_EACH_2(m, x, ...) m(x), _SJSON_EXPAND(_SJSON_FOR_EACH_1(m, __VA_ARGS__))
+#define _SJSON_FOR_EACH_3(m, x, ...) m(x), _SJSON_EXPAND(_SJSON_FOR_EACH_2(m, __VA_ARGS__))
+#define _SJSON_FOR_EACH_4(m, x, ...) m(x), _SJSON_EXPAND(_SJSON_FOR_EACH_3(m, __VA_ARGS__))
+#define _SJSON_FOR_EACH_5(m, x, ...) m(x), _SJSON_EXPAND(_SJSON_FOR_EACH_4(m, __VA_ARGS__))
+#define _SJSON_FOR_EACH_6(m, x, ...) m(x), _SJSON_EXPAND(_SJSON_FOR_EACH_5(m, __VA_ARGS__))
+#define _SJSON_FOR_EACH_7(m, x, ...) m(x), _SJSON_EXPAND(_SJSON_FOR_EACH_6(m, __VA_ARGS__))
+#define _SJSON_FOR_EACH_8(m, x, ...) m(x), _SJSON_EXPAND(_SJSON_FOR_EACH_7(m, __VA_ARGS__))
+#define _SJSON_FOR_EACH_9(m, x, ...) m(x), _SJSON_EXPAND(_SJSON_FOR_EACH_8(m, __VA_ARGS__))
+#define _SJSON_FOR_EACH_10(m, x, ...) m(x), _SJSON_EXPAND(_SJSON_FOR_EACH_9(m, __VA_ARGS__))
+#define _SJSON_FOR_EACH_11(m, x, ...) m(x), _SJSON_EXPAND(_SJSON_FOR_EACH_10(m, __VA_ARGS__))
+#define _SJSON_FOR_EACH_12(m, x, ...) m(x), _SJSON_EXPAND(_SJSON_FOR_EACH_11(m, __VA_ARGS__))
+#define _SJSON_FOR_EACH_13(m, x, ...) m(x), _SJSON_EXPAND(_SJSON_FOR_EACH_12(m, __VA_ARGS__))
+#define _SJSON_FOR_EACH_14(m, x, ...) m(x), _SJSON_EXPAND(_SJSON_FOR_EACH_13(m, __VA_ARGS__))
+#define _SJSON_FOR_EACH_15(m, x, ...) m(x), _SJSON_EXPAND(_SJSON_FOR_EACH_14(m, __VA_ARGS__))
+#define _SJSON_FOR_EACH_16(m, x, ...) m(x), _SJSON_EXPAND(_SJSON_FOR_EACH_15(m, __VA_ARGS__))
+#define _SJSON_FOR_EACH_17(m, x, ...) m(x), _SJSON_EXPAND(_SJSON_FOR_EACH_16(m, __VA_ARGS__))
+#define _SJSON_FOR_EACH_18(m, x, ...) m(x), _SJSON_EXPAND(_SJSON_FOR_EACH_17(m, __VA_ARGS__))
+#define _SJSON_FOR_EACH_19(m, x, ...) m(x), _SJSON_EXPAND(_SJSON_FOR_EACH_18(m, __VA_ARGS__))
+#define _SJSON_FOR_EACH_20(m, x, ...) m(x), _SJSON_EXPAND(_SJSON_FOR_EACH_19(m, __VA_ARGS__))
+#define _SJSON_FOR_EACH_21(m, x, ...) m(x), _SJSON_EXPAND(_SJSON_FOR_EACH_20(m, __VA_ARGS__))
+#define _SJSON_FOR_EACH_22(m, x, ...) m(x), _SJSON_EXPAND(_SJSON_FOR_EACH_21(m, __VA_ARGS__))
+#define _SJSON_FOR_EACH_23(m, x, ...) m(x), _SJSON_EXPAND(_SJSON_FOR_EACH_22(m, __VA_ARGS__))
+#define _SJSON_FOR_EACH_24(m, x, ...) m(x), _SJSON_EXPAND(_SJSON_FOR_EACH_23(m, __VA_ARGS__))
+#define _SJSON_FOR_EACH_25(m, x, ...) m(x), _SJSON_EXPAND(_SJSON_FOR_EACH_24(m, __VA_ARGS__))
+#define _SJSON_FOR_EACH_26(m, x, ...) m(x), _SJSON_EXPAND(_SJSON_FOR_EACH_25(m, __VA_ARGS__))
+#define _SJSON_FOR_EACH_27(m, x, ...) m(x), _SJSON_EXPAND(_SJSON_FOR_EACH_26(m, __VA_ARGS__))
+#define _SJSON_FOR_EACH_28(m, x, ...) m(x), _SJSON_EXPAND(_SJSON_FOR_EACH_27(m, __VA_ARGS__))
+#define _SJSON_FOR_EACH_29(m, x, ...) m(x), _SJSON_EXPAND(_SJSON_FOR_EACH_28(m, __VA_ARGS__))
+#define _SJSON_FOR_EACH_30(m, x, ...) m(x), _SJSON_EXPAND(_SJSON_FOR_EACH_29(m, __VA_ARGS__))
+#define _SJSON_FOR_EACH_31(m, x, ...) m(x), _SJSON_EXPAND(_SJSON_FOR_EACH_30(m, __VA_ARGS__))
+#define _SJSON_FOR_EACH_32(m, x, ...) m(x), _SJSON_EXPAND(_SJSON_FOR_EACH_31(m, __VA_ARGS__))
+
+#define _SJSON_BIND_FIELD(member) ::sjson::_sjson_detail::make_bound_field(#member, &_sjson_bound_t::member)
+
+#define SJSON_BIND(type, ...) \
+inline constexpr auto sjson_bound_fields(const type*) \
+{ \
+	using _sjson_bound_t = type; \
+	return std::make_tuple(_SJSON_FOR_EACH(_SJSON_BIND_FIELD, __VA_ARGS__)); \
+}
+
+namespace _sjson_detail
+{
+	/*
+	* 绑定的成员：键的长度是编译期常量，查找成员时先比较长度再比较内容
+	*/
+	template<size_t _n, typename _cls_t, typename _mem_t>
+	struct bound_field
+	{
+		static constexpr size_t name_size = _n - 1;
+		const char* name;
+		_mem_t _cls_t::* ptr;
+	};
+
+	template<typename _cls_t, size_t _n, typename _mem_t>
+	constexpr bound_field<_n, _cls_t, _mem_t> make_bound_field(const char(&name)[_n], _mem_t _cls_t::* ptr)
+	{
+		return { name, ptr };
+	}
+
+	// 通过 ADL 查找 SJSON_BIND 生成的 sjson_bound_fields
+	template<typename _t, typename = void>
+	struct is_bound :std::false_type {};
+	template<typename _t>
+	struct is_bound<_t, std::void_t<decltype(sjson_bound_fields(static_cast<const _t*>(nullptr)))>> :std::true_type {};
+
+	template<typename _t>
+	struct is_vector :std::false_type {};
+	template<typename _t, typename _alloc_t>
+	struct is_vector<std::vector<_t, _alloc_t>> :std::true_type {};
+
+	template<typename _t>
+	struct is_optional :std::false_type {};
+	template<typename _t>
+	struct is_optional<std::optional<_t>> :std::true_type {};
+
+	template<typename _t>
+	struct is_string_view :std::false_type {};
+	template<typename _char_t, typename _traits_t>
+	struct is_string_view<std::basic_string_view<_char_t, _traits_t>> :std::true_type {};
+
+	/**
+	 * @brief 按键查找 _t 的绑定成员并以该成员调用 func
+	 * @return 是否找到
+	 */
+	template<typename _t, typename _func_t>
+	bool visit_bound_field(std::string_view key, _func_t&& func)
+	{
+		constexpr auto fields = sjson_bound_fields(static_cast<const _t*>(nullptr));
+		return std::apply([&](const auto&... fs)
+			{
+				return ((key.size() == std::decay_t<decltype(fs)>::name_size
+					&& std::char_traits<char>::compare(key.data(), fs.name, key.size()) == 0
+					&& (func(fs), true)) || ...);
+			}, fields);
+	}
+
+	template<typename _t>
+	void dump_bound_to(const _t& x, std::string& out)
+	{
+		if constexpr (is_bound<_t>::value)
+		{
+			constexpr auto fields = sjson_bound_fields(static_cast<const _t*>(nullptr));
+			out += '{';
+			std::apply([&](const auto&... fs)
+				{
+					bool first = true;
+					((out += first ? "\"" : ",\"", first = false,
+						out.append(fs.name, std::decay_t<decltype(fs)>::name_size), out += "\":",
+						_sjson_detail::dump_bound_to(x.*fs.ptr, out)), ...);
+				}, fields);
+			out += '}';
+		}
+		else if constexpr (is_vector<_t>::value)
+		{
+			out += '[';
+			for (size_t i = 0; i < x.size(); ++i)
+			{
+				if (i)out += ',';
+				_sjson_detail::dump_bound_to(x[i], out);
+			}
+			out += ']';
+		}
+		else if constexpr (is_optional<_t>::value)
+		{
+			if (x)_sjson_detail::dump_bound_to(*x, out);
+			else out += "null";
+		}
+		else if constexpr (std::is_same_v<_t, bool>)
+		{
+			out += x ? "true" : "false";
+		}
+		else if constexpr (std::is_floating_point_v<_t>)
+		{
+			dump_double_to(x, out);
+		}
+		else if constexpr (std::is_arithmetic_v<_t>)
+		{
+			out += std::to_string(x);
+		}
+		else if constexpr (std::is_same_v<_t, std::string> || std::is_same_v<_t, std::string_view>)
+		{
+			out += '"';
+			escape_to_ascii(x, out);
+			out += '"';
+		}
+		else
+		{
+			// json
+			x.dump_to(out, 0);
+		}
+	}
+}
+
+#pragma endregion
+
+namespace _sjson_detail
+{
+	template<typename _json_t>
+	class parser
+	{
+	private:
+
+		template<typename>
+		friend class sjson::_basic_lazy_document;
+
+		using _error = json_parse_error;
+		using _origin = json_error_origin;
+
+		using _char_t = _json_t::string_char_t;
+		using _str_t = _json_t::string_t;
+
+		/*
+		* 字符串类型为 string_view 时为原地解析模式：字符串与键直接引用输入缓冲区，
+		* 含转义的字符串在缓冲区内原地解码（解码结果不会比原文长），
+		* 因此只能从调用者提供的可写连续内存解析，解析结果的生命周期不能超过该缓冲区
+		*/
+		static constexpr bool _view_mode = std::is_same_v<_str_t, std::basic_string_view<_char_t>>;
+
+	public:
+
+		static constexpr _char_t end_flag = 0;
+		/*
+		* 块读取函数：向 buf 写入至多 n 个字符，返回实际写入的数量（返回 0 表示输入结束）
+		* 仅用于非连续的输入（一般迭代器、流），连续内存直接按指针访问
+		*/
+		using read_f = std::function<size_t(_char_t* buf, size_t n)>;
+
+	private:
+
+		struct _text_pos
+		{
+			uint32_t line = 0, column = 0;
+		};
+
+		static constexpr size_t _read_block_size = 1 << 16;
+
+		/*
+		* 输入窗口 [_beg, _end)，_pos 指向 _cur_ch
+		* 连续输入时窗口即为整个输入；否则窗口为 _read_buf 中的内容，耗尽时由 _refill 补充
+		*/
+		const _char_t* _beg = nullptr;
+		const _char_t* _pos = nullptr;
+		const _char_t* _end = nullptr;
+		_char_t _cur_ch = end_flag;
+
+		read_f _read_func;
+		std::vector<_char_t> _read_buf;
+		bool _read_eof = false;
+
+		/*
+		* 行列号只在报错时计算：
+		* 记录窗口之前（已被丢弃的部分）的偏移、行数以及最后一行的起始偏移
+		*/
+		size_t _base_ofs = 0;
+		uint32_t _base_line = 0;
+		size_t _base_line_beg = 0;
+
+		size_t _cur_node_start = 0;
+		_text_pos _cur_node_start_pos;
+		bool _cur_node_start_resolved = true; // 未标记过起始位置时报告 0:0
+
+		_json_t _cur_node;
+		size_t _token_ofs = 0; // 最近一个 token（跳过注释后）的起始偏移
+		bool _skim = false; // 只跳过值而不解码（字符串、数字、关键词都读为 null，不检查其语法）
+		/*
+		* 容器的最大嵌套层数，为 0 时不限制
+		* 解析本身不递归，但 json 的析构、dump 等仍是递归的，默认限制以免它们耗尽栈
+		*/
+		static constexpr size_t _default_max_depth = 10000;
+		size_t _max_depth = _default_max_depth;
+
+		// 原地解析模式下的字符串池（见 set_string_pool）
+		basic_string_pool<_char_t>* _pool = nullptr;
+		size_t _pool_max_len = 0;
+
+		bool _raw_numbers = false; // 数字只保存原文（见 set_raw_numbers）
+
+		// 新建的字符串与容器所用的内存资源（仅 pmr 的 json，见 set_memory_resource）
+		std::pmr::memory_resource* _res = std::pmr::get_default_resource();
+
+		template<typename... _args>
+		_str_t _new_str(_args&&... args)const
+		{
+			if constexpr (_json_t::uses_pmr)return _str_t(std::forward<_args>(args)..., typename _str_t::allocator_type(_res));
+			else return _str_t(std::forward<_args>(args)...);
+		}
+		_json_t _new_node(json_value_t t)const
+		{
+			if constexpr (_json_t::uses_pmr)return _json_t(std::allocator_arg, typename _json_t::allocator_type(_res), t);
+			else return _json_t(t);
+		}
+
+		bool _is_abort = false;
+		json_parse_error_callback_f _err_callback;
+
+		/*
+		* 推送模式（见 feed）：输入尚未结束时窗口耗尽不视为结尾，
+		* 而是记录下来，由 _run_push 退回到 token 开头等待更多输入
+		*/
+		bool _feeding = false;
+		bool _starved = false;
+		bool _push_mode = false; // 以 push 构造，reset 后恢复 _feeding
+
+		struct _pending_err
+		{
+			_text_pos pos;
+			json_error_origin origin;
+			json_parse_error e;
+			std::string msg;
+		};
+		// 推送模式下 token 确认完整之前产生的错误
+		std::vector<_pending_err> _pending_errs;
+
+		void _throw_err(
+			json_error_origin origin,
+			json_parse_error e, const std::string& msg = ""
+		)
+		{
+			if (_err_callback)
+			{
+				_text_pos pos = _cur_node_start_resolved
+					? _cur_node_start_pos
+					: _pos_of(_cur_node_start);
+				if (_feeding)
+				{
+					_pending_errs.push_back({ pos, origin, e, msg });
+					return;
+				}
+				_report_err(pos, origin, e, msg);
+			}
+		}
+		void _report_err(
+			const _text_pos& pos, json_error_origin origin,
+			json_parse_error e, const std::string& msg
+		)
+		{
+			if (
+				_err_callback(
+					pos.line,
+					pos.column,
+					origin, e, msg
+				) == json_callback_ret::abort
+				) {
+				_cur_ch = end_flag;
+				_is_abort = true;
+			}
+		}
+
+		constexpr static bool _isdigit(_char_t ch, int base = 10)
+		{
+			return ('0' <= ch && ch <= '9')
+				|| ('A' <= ch && ch < 'A' + (base -= 10))
+				|| ('a' <= ch && ch < 'a' + base);
+		}
+		constexpr static bool _isalpha(_char_t ch)
+		{
+			return ('a' <= ch && ch <= 'z') || ('A' <= ch && ch <= 'Z');
+		}
+		constexpr static bool _isalnum(_char_t ch, int base = 10)
+		{
+			return _isalpha(ch) || _isdigit(ch, base);
+		}
+		constexpr static bool _isspace(_char_t ch)
+		{
+			return ch == ' ' || ('\t' <= ch && ch <= '\r');
+		}
+
+		// 当前字符的绝对偏移
+		size_t _cur_ofs()const { return _base_ofs + (_pos - _beg); }
+
+		/**
+		 * \param ofs 绝对偏移（不能位于已丢弃的部分）
+		 * \return ofs 处字符的行列号（行从 0 开始，列从 1 开始，换行符本身位于下一行的第 0 列）
+		 */
+		_text_pos _pos_of(size_t ofs)const
+		{
+			_text_pos res;
+			res.line = _base_line;
+			size_t line_beg = _base_line_beg;
+			size_t n = (std::min)(ofs - _base_ofs + 1, static_cast<size_t>(_end - _beg));
+			for (size_t i = 0; i < n; ++i)
+			{
+				if (_beg[i] == '\n')
+				{
+					res.line++;
+					line_beg = _base_ofs + i + 1;
+				}
+			}
+			res.column = static_cast<uint32_t>(ofs + 1 - line_beg);
+			return res;
+		}
+
+		void _mark_node_start()
+		{
+			_cur_node_start = _cur_ofs();
+			_cur_node_start_resolved = false;
+		}
+
+		/*
+		* 流式与推送输入的 UTF-8 校验（见 validate_utf8）：每读入一块就校验新增的部分，
+		* 末尾不完整的多字节序列留在窗口中，等后续字节读入后再一起校验
+		*/
+		bool _check_utf8 = false;
+		size_t _utf8_ofs = 0; // 已校验到的绝对偏移
+
+		// 校验窗口中 _utf8_ofs 之后的部分，eof 为 true 时末尾不完整的序列也是不合法的
+		bool _check_utf8_window(bool eof)
+		{
+			const char* from = _raw(_beg + (_utf8_ofs - _base_ofs));
+			const char* to = _raw(_end);
+			if (!eof)
+			{
+				// 退回到末尾不完整序列的首字节
+				for (const char* q = to; q != from && to - q < 4;)
+				{
+					auto ch = static_cast<unsigned char>(*--q);
+					if ((ch & 0xC0) == 0x80)continue;
+					size_t len = ch >= 0xF0 ? 4 : ch >= 0xE0 ? 3 : ch >= 0xC0 ? 2 : 1;
+					if (static_cast<size_t>(to - q) < len)to = q;
+					break;
+				}
+			}
+			const char* bad = simd::validate_utf8(from, to);
+			if (bad != to)
+			{
+				// 只报告第一处，不受 token 是否完整的影响（推送模式下也直接报告）
+				_check_utf8 = false;
+				size_t ofs = _base_ofs + (_from_raw(bad) - _beg);
+				_report_err(_pos_of(ofs), json_error_origin::validate_utf8, _error::invalid_utf8, std::to_string(ofs));
+				return false;
+			}
+			_utf8_ofs = _base_ofs + (_from_raw(to) - _beg);
+			return true;
+		}
+		// 丢弃窗口的前部时保留尚未校验的字节
+		const _char_t* _utf8_keep(const _char_t* keep)const
+		{
+			return _check_utf8 ? (std::min)(keep, _beg + (_utf8_ofs - _base_ofs)) : keep;
+		}
+
+		/**
+		 * \brief 窗口耗尽时读取下一块，[keep, _end) 中的字符会被保留
+		 * \return 是否读到了新的字符
+		 */
+		bool _refill(const _char_t* keep)
+		{
+			if (_feeding)
+			{
+				_starved = true;
+				return false;
+			}
+			if (!_read_func || _read_eof)return false;
+			keep = _utf8_keep(keep);
+
+			size_t kept = _end - keep;
+			size_t pos_idx = _pos - keep;
+			_discard_before(keep);
+
+			if (kept && keep != _read_buf.data())
+				std::copy(keep, keep + kept, _read_buf.data());
+			if (_read_buf.size() < kept + _read_block_size)
+				_read_buf.resize(kept + _read_block_size);
+
+			size_t n = _read_func(_read_buf.data() + kept, _read_buf.size() - kept);
+			if (n == 0)_read_eof = true;
+
+			_beg = _read_buf.data();
+			_pos = _beg + pos_idx;
+			_end = _beg + kept + n;
+			if constexpr (sizeof(_char_t) == 1)
+			{
+				if (_check_utf8)_check_utf8_window(n == 0);
+			}
+			return n != 0;
+		}
+
+		// 丢弃窗口中 keep 之前的部分前先结算行号（若结点起始位置将被丢弃则先计算出它的行列号）
+		void _discard_before(const _char_t* keep)
+		{
+			size_t drop = keep - _beg;
+			if (!_cur_node_start_resolved && _cur_node_start < _base_ofs + drop)
+			{
+				_cur_node_start_pos = _pos_of(_cur_node_start);
+				_cur_node_start_resolved = true;
+			}
+			for (size_t i = 0; i < drop; ++i)
+			{
+				if (_beg[i] == '\n')
+				{
+					_base_line++;
+					_base_line_beg = _base_ofs + i + 1;
+				}
+			}
+			_base_ofs += drop;
+		}
+
+		void _set_input(const _char_t* s, size_t n)
+		{
+			_beg = _pos = s;
+			_end = s + n;
+			_cur_ch = n ? *_pos : end_flag;
+		}
+		void _set_input(read_f f)
+		{
+			_read_func = std::move(f);
+			_refill(_end);
+			_cur_ch = _pos != _end ? *_pos : end_flag;
+		}
+
+		/*
+		* 从流中按块读取：每次只取走流缓冲区中已有的字符（为空时才触发一次底层读取），
+		* 这样读多了的部分仍在流缓冲区内，解析结束后可以用 _unread_to 退回
+		*/
+		static read_f _make_stream_reader(std::istream& is)
+		{
+			using traits = std::istream::traits_type;
+			if constexpr (std::is_same_v<_char_t, char>)
+			{
+				return [&is](_char_t* buf, size_t n)
+				{
+					auto* sb = is.rdbuf();
+					std::streamsize avail = sb->in_avail();
+					if (avail <= 0)
+					{
+						if (traits::eq_int_type(sb->sgetc(), traits::eof()))
+						{
+							is.setstate(std::ios::eofbit);
+							return size_t(0);
+						}
+						avail = std::max<std::streamsize>(sb->in_avail(), 1);
+					}
+					avail = (std::min)(avail, static_cast<std::streamsize>(n));
+					return static_cast<size_t>(sb->sgetn(buf, avail));
+				};
+			}
+			else
+			{
+				return [&is](_char_t* buf, size_t n)
+				{
+					auto ch = is.rdbuf()->sbumpc();
+					if (traits::eq_int_type(ch, traits::eof()))
+					{
+						is.setstate(std::ios::eofbit);
+						return size_t(0);
+					}
+					*buf = static_cast<_char_t>(traits::to_char_type(ch));
+					return size_t(1);
+				};
+			}
+		}
+
+		/*
+		* 将已从流中读出但没有被解析的字符退回流中。要么全部退回，要么一个也不退回：
+		* 流缓冲区放不下时（例如中途已触发过 underflow）把已退回的字符重新取走，
+		* 并给流设置 failbit，避免流中留下缺了一段的数据
+		*/
+		bool _unread_to(std::istream& is)
+		{
+			using traits = std::istream::traits_type;
+			auto* sb = is.rdbuf();
+			size_t done = 0, total = _end - _pos;
+			for (const _char_t* p = _end; p != _pos; ++done)
+			{
+				--p;
+				auto ch = traits::to_char_type(static_cast<traits::int_type>(*p));
+				if (traits::eq_int_type(sb->sungetc(), traits::eof())
+					&& traits::eq_int_type(sb->sputbackc(ch), traits::eof())
+					) {
+					break;
+				}
+			}
+			if (done != total)
+			{
+				for (; done; --done)sb->sbumpc();
+				is.setstate(std::ios::failbit);
+				return false;
+			}
+			if (total && is.eof())is.clear(is.rdstate() & ~std::ios::eofbit);
+			return true;
+		}
+
+		_char_t _look_nextch()
+		{
+			if (_is_abort || _pos == _end)return end_flag;
+			if (_pos + 1 == _end && !_refill(_pos))return end_flag;
+			return _pos[1];
+		}
+		void _get_nextch()
+		{
+			if (_is_abort || _pos == _end)return;
+			if (++_pos == _end && !_refill(_pos))
+			{
+				_cur_ch = end_flag;
+				return;
+			}
+			_cur_ch = *_pos;
+		}
+
+		static const char* _raw(const _char_t* p) { return reinterpret_cast<const char*>(p); }
+		static const _char_t* _from_raw(const char* p) { return reinterpret_cast<const _char_t*>(p); }
+
+		// 直接移动 _pos 后更新 _cur_ch（_pos 到达窗口末尾时补充输入）
+		void _sync_cur_ch()
+		{
+			if (_pos == _end && !_refill(_pos))
+			{
+				_cur_ch = end_flag;
+				return;
+			}
+			_cur_ch = *_pos;
+		}
+		bool _match_ch(_char_t want)
+		{
+			return _look_nextch() == want ? _get_nextch(), true : false;
+		}
+
+		inline bool _is_end()const { return !bool(_cur_ch); }
+
+		void _skip_space()
+		{
+			if constexpr (sizeof(_char_t) == 1)
+			{
+				while (_isspace(_cur_ch))
+				{
+					_pos = _from_raw(simd::skip_space(_raw(_pos), _raw(_end)));
+					_sync_cur_ch();
+				}
+			}
+			else
+			{
+				while (_isspace(_cur_ch))
+				{
+					_get_nextch();
+				}
+			}
+		}
+		void _skip_line()
+		{
+			while (_cur_ch != end_flag)
+			{
+				if (_cur_ch == '\n')
+				{
+					_get_nextch();
+					break;
+				}
+				_get_nextch();
+			}
+		}
+		void _skip_comment()
+		{
+			if (_match_ch('/')) // 单行注释
+			{
+				_skip_line();
+			}
+			else if (_match_ch('*'))
+			{
+				_get_nextch();
+				bool comment_closed = false;
+				while (_cur_ch != end_flag)
+				{
+					_mark_node_start();
+					if (_cur_ch == '*')
+					{
+						if (_match_ch('/'))
+						{
+							_get_nextch();
+							comment_closed = true;
+							break;
+						}
+					}
+					_get_nextch();
+				}
+				if (!comment_closed)
+				{
+					// 错误 注释未闭合
+					_throw_err(_origin::parse_comment, _error::item_not_closed);
+				}
+			}
+		}
+
+		// 转换得到的数字，type 为 null 时表示没有数字
+		struct _num_val
+		{
+			json_value_t type = json_value_t::null;
+			int64_t i = 0; // num_i32、num_i64
+			uint64_t u = 0; // num_ui64
+			double d = 0; // num_double
+		};
+
+		static _json_t _num_node(const _num_val& v)
+		{
+			switch (v.type)
+			{
+			case json_value_t::num_i32: return static_cast<int32_t>(v.i);
+			case json_value_t::num_i64: return v.i;
+			case json_value_t::num_ui64: return v.u;
+			case json_value_t::num_double: return v.d;
+			default: return nullptr;
+			}
+		}
+
+		/*
+		* 词法单元（见 _scan）：token 机器只看它，不为每个 token 构建 json 结点
+		* 不含转义的字符串直接指向输入窗口，含转义的解码到 _lex_buf（原地解析模式下总是指向输入），
+		* 数字在读取时即转换完毕；字符串的内容只在读取下一个单元之前有效
+		*/
+		enum class _lex_t : uint8_t
+		{
+			delimiter, // 包括表示输入结尾的 _end_delimiter
+			string,
+			number,
+			raw_number, // 只记录原文（见 set_raw_numbers）
+			boolean,
+			null
+		};
+		struct _lexeme
+		{
+			_lex_t kind = _lex_t::null;
+			parser_delimiter delim{};
+			bool boolean = false;
+			bool integral = false, fits_int64 = false; // raw_number 的分类
+			std::basic_string_view<_char_t> str; // string 的内容或 raw_number 的原文
+			_num_val num;
+		};
+		_lexeme _lex;
+		std::basic_string<_char_t> _lex_buf;
+
+		static constexpr parser_delimiter _end_delimiter = static_cast<parser_delimiter>(end_flag);
+
+		bool _lex_is(parser_delimiter d)const { return _lex.kind == _lex_t::delimiter && _lex.delim == d; }
+
+		// 按当前的词法单元构建结点
+		_str_t _lex_string()
+		{
+			if constexpr (_view_mode)
+			{
+				if (_pool && _lex.str.size() <= _pool_max_len)return _pool->intern(_str_t(_lex.str));
+				return _str_t(_lex.str);
+			}
+			else return _new_str(_lex.str.data(), _lex.str.size());
+		}
+		_json_t _lex_node()
+		{
+			switch (_lex.kind)
+			{
+			case _lex_t::delimiter: return _lex.delim;
+			case _lex_t::string: return _lex_string();
+			case _lex_t::number: return _num_node(_lex.num);
+			case _lex_t::raw_number:
+				return typename _json_t::raw_number_t{ _new_str(_lex.str.data(), _lex.str.size()), _lex.integral, _lex.fits_int64 };
+			case _lex_t::boolean: return _lex.boolean;
+			default: return nullptr;
+			}
+		}
+
+		/**
+		 * \brief 将 [beg, end) 按 strtod 的规则（取最长的合法前缀）转换为数字
+		 * \param is_float 是否含有小数点或指数（否则优先使用整数类型）
+		 * \return 整数依次尝试 int32、int64、uint64，都放不下或为浮点数时使用 double
+		 */
+		_num_val _make_number(const _char_t* beg, const _char_t* end, bool is_float)
+		{
+			auto int_val = [](json_value_t t, int64_t i) { _num_val v; v.type = t; v.i = i; return v; };
+			constexpr uint64_t max_u64 = std::numeric_limits<uint64_t>::max();
+
+			const _char_t* p = beg;
+			bool neg = false;
+			if (p != end && (*p == '-' || *p == '+'))neg = *p++ == '-';
+			const _char_t* digits_beg = p;
+
+			if (!is_float)
+			{
+				uint64_t val = 0;
+				bool overflow = false;
+				for (; p != end && _isdigit(*p); ++p)
+				{
+					uint64_t d = *p - '0';
+					if (val > (max_u64 - d) / 10)overflow = true;
+					val = val * 10 + d;
+				}
+				if (p != digits_beg && !overflow)
+				{
+					constexpr uint64_t i32_lim = uint64_t(std::numeric_limits<int32_t>::max());
+					constexpr uint64_t i64_lim = uint64_t(std::numeric_limits<int64_t>::max());
+					if (neg)
+					{
+						if (val <= i32_lim + 1)return int_val(json_value_t::num_i32, static_cast<int64_t>(0 - val));
+						if (val <= i64_lim + 1)return int_val(json_value_t::num_i64, static_cast<int64_t>(0 - val));
+					}
+					else
+					{
+						if (val <= i32_lim)return int_val(json_value_t::num_i32, static_cast<int64_t>(val));
+						if (val <= i64_lim)return int_val(json_value_t::num_i64, static_cast<int64_t>(val));
+						_num_val v;
+						v.type = json_value_t::num_ui64;
+						v.u = val;
+						return v;
+					}
+				}
+				// 超出整数范围，按浮点数处理
+				p = digits_beg;
+			}
+
+			/*
+			* 快速路径：有效数字不超过 2^53 且 10 的幂次在 [-22, 22] 内时，
+			* 一次浮点乘除即为正确舍入的结果
+			*/
+			uint64_t mant = 0;
+			int sig_digits = 0, exp10 = 0;
+			bool any_digit = false, exact = true;
+			auto take_digit = [&](_char_t ch)
+			{
+				any_digit = true;
+				if (mant == 0 && ch == '0')return false;
+				if (sig_digits < 19)
+				{
+					mant = mant * 10 + (ch - '0');
+					sig_digits++;
+					return false;
+				}
+				if (ch != '0')exact = false;
+				return true;
+			};
+			for (; p != end && _isdigit(*p); ++p)
+			{
+				if (take_digit(*p))exp10++;
+			}
+			if (p != end && *p == '.')
+			{
+				for (++p; p != end && _isdigit(*p); ++p)
+				{
+					if (!take_digit(*p))exp10--;
+				}
+			}
+			if (!any_digit)
+			{
+				_throw_err(
+					_origin::parse_number,
+					_error::unexpected_item,
+					"<number>@" + std::string(beg, end)
+				);
+				return _num_val();
+			}
+			if (p != end && (*p == 'e' || *p == 'E'))
+			{
+				const _char_t* q = p + 1;
+				bool exp_neg = false;
+				if (q != end && (*q == '-' || *q == '+'))exp_neg = *q++ == '-';
+				if (q != end && _isdigit(*q))
+				{
+					int e = 0;
+					for (; q != end && _isdigit(*q); ++q)
+					{
+						if (e < 100000)e = e * 10 + (*q - '0');
+					}
+					exp10 += exp_neg ? -e : e;
+					p = q;
+				}
+			}
+			end = p;
+
+			static constexpr double pow10[] = {
+				1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+				1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20,
+				1e21, 1e22
+			};
+			double res;
+			if (mant == 0)res = 0.0;
+			else if (exact && mant <= (uint64_t(1) << 53) && -22 <= exp10 && exp10 <= 22)
+			{
+				res = static_cast<double>(mant);
+				res = exp10 < 0 ? res / pow10[-exp10] : res * pow10[exp10];
+			}
+			else
+			{
+				// 其余情况交给 from_chars（不依赖 locale，且保证正确舍入）
+				std::from_chars_result r;
+				if constexpr (sizeof(_char_t) == 1)
+				{
+					r = std::from_chars(_raw(digits_beg), _raw(end), res, std::chars_format::general);
+				}
+				else
+				{
+					std::string narrow(digits_beg, end);
+					r = std::from_chars(narrow.data(), narrow.data() + narrow.size(), res, std::chars_format::general);
+				}
+				if (r.ec == std::errc::result_out_of_range)
+				{
+					res = exp10 + sig_digits > 0
+						? std::numeric_limits<double>::infinity()
+						: 0.0;
+				}
+			}
+			_num_val v;
+			v.type = json_value_t::num_double;
+			v.d = neg ? -res : res;
+			return v;
+		}
+
+		// 读取一个数字到 _lex（见 _scan）
+		void _scan_num()
+		{
+			bool is_float = false;
+			const _char_t* beg = _pos;
+
+			// 数字在窗口末尾被截断时，补充输入并保留已读的部分
+			auto next = [this, &beg]()
+			{
+				if (++_pos == _end)
+				{
+					size_t len = _pos - beg;
+					bool ok = _refill(beg);
+					beg = _pos - len;
+					if (!ok)
+					{
+						_cur_ch = end_flag;
+						return;
+					}
+				}
+				_cur_ch = *_pos;
+			};
+
+			if (_cur_ch == '-' || _cur_ch == '+')next();
+			while (true)
+			{
+				while (_isdigit(_cur_ch))next();
+				if (_cur_ch == '.')
+				{
+					next();
+					is_float = true;
+					continue;
+				}
+				else if (_cur_ch == 'e' || _cur_ch == 'E')
+				{
+					next();
+					if (_cur_ch == '-' || _cur_ch == '+')next();
+					is_float = true;
+					continue;
+				}
+				break;
+			}
+
+			if (_raw_numbers)
+			{
+				const _char_t* p = _raw_number_prefix(beg, _pos, _lex.integral, _lex.fits_int64);
+				_lex.kind = p ? _lex_t::raw_number : _lex_t::null;
+				if (p)_lex.str = { beg, static_cast<size_t>(p - beg) };
+				return;
+			}
+			_lex.num = _make_number(beg, _pos, is_float);
+			_lex.kind = _lex.num.type == json_value_t::null ? _lex_t::null : _lex_t::number;
+		}
+
+		/**
+		 * \brief 取 [beg, end) 中最长的合法数字前缀（规则同 _make_number），只记录原文与分类而不转换
+		 * \return 前缀的结尾，没有数字时报错并返回 nullptr
+		 */
+		const _char_t* _raw_number_prefix(const _char_t* beg, const _char_t* end, bool& integral, bool& fits_int64)
+		{
+			const _char_t* p = beg;
+			if (p != end && (*p == '-' || *p == '+'))++p;
+			const _char_t* int_beg = p;
+			while (p != end && _isdigit(*p))++p;
+			size_t int_digits = p - int_beg;
+			bool any_digit = int_digits != 0;
+			integral = true;
+			if (p != end && *p == '.')
+			{
+				integral = false;
+				const _char_t* frac_beg = ++p;
+				while (p != end && _isdigit(*p))++p;
+				any_digit = any_digit || p != frac_beg;
+			}
+			if (!any_digit)
+			{
+				_throw_err(
+					_origin::parse_number,
+					_error::unexpected_item,
+					"<number>@" + std::string(beg, end)
+				);
+				return nullptr;
+			}
+			if (p != end && (*p == 'e' || *p == 'E'))
+			{
+				const _char_t* q = p + 1;
+				if (q != end && (*q == '-' || *q == '+'))++q;
+				if (q != end && _isdigit(*q))
+				{
+					while (q != end && _isdigit(*q))++q;
+					integral = false;
+					p = q;
+				}
+			}
+			fits_int64 = integral && int_digits <= 18;
+			return p;
+		}
+
+		template<typename _buf_t>
+		void _parse_unicode_to(_buf_t& s)
+		{
+			uint32_t idx = 0, val = 0;
+			uint8_t digit = 0;
+
+			std::string buf = "\\u";
+
+			while (idx++ < 4)
+			{
+				_get_nextch();
+				_mark_node_start();
+				buf.push_back(static_cast<char>(_cur_ch));
+				if (_is_end())
+				{
+					// 错误 字符串未闭合
+					_throw_err(_origin::parse_string, _error::item_not_closed);
+					break;
+				}
+				else if ('0' <= _cur_ch && _cur_ch <= '9')
+				{
+					digit = _cur_ch - '0';
+				}
+				else if ('a' <= _cur_ch && _cur_ch <= 'f')
+				{
+					digit = _cur_ch - 'a' + 10;
+				}
+				else if ('A' <= _cur_ch && _cur_ch <= 'F')
+				{
+					digit = _cur_ch - 'A' + 10;
+				}
+				else
+				{
+					// 错误 非法的 unicode 转义
+					_throw_err(_origin::parse_unicode, _error::illegal_escape, buf);
+					break;
+				}
+				val = val * 16 | digit;
+			}
+
+			auto need = _sjson_detail::utf8::get_byte_num_of_encode(val);
+
+			if (need == 0)
+			{
+				// 错误 无效的 unicode
+				_throw_err(_origin::parse_unicode, _error::invalid_unicode_code, buf);
+				return;
+			}
+
+			s.resize(s.size() + need);
+
+			_sjson_detail::utf8::encode((uint8_t*)s.data() + s.size() - need, val);
+		}
+
+		/*
+		* 原地解码字符串时的输出位置：从字符串开头（左引号之后）写起，
+		* 写入位置始终不超过读取位置，未遇到转义前不需要移动任何字符
+		*/
+		struct _in_place_str
+		{
+			_char_t* beg;
+			size_t len = 0;
+
+			size_t size()const { return len; }
+			_char_t* data() { return beg; }
+			void resize(size_t n) { len = n; }
+			void push_back(_char_t ch) { beg[len++] = ch; }
+			void append(const _char_t* first, const _char_t* last)
+			{
+				if (first != beg + len)std::memmove(beg + len, first, (last - first) * sizeof(_char_t));
+				len += last - first;
+			}
+		};
+
+		// 将字符串中直到 '"'、'\\' 或结尾之前的字符整段追加到 buf
+		template<typename _buf_t>
+		void _append_string_run(_buf_t& buf)
+		{
+			if constexpr (sizeof(_char_t) == 1)
+			{
+				while (!_is_end() && _cur_ch != '"' && _cur_ch != '\\')
+				{
+					const _char_t* run_end = _from_raw(simd::find_string_special(_raw(_pos), _raw(_end)));
+					buf.append(_pos, run_end);
+					_pos = run_end;
+					_sync_cur_ch();
+				}
+			}
+			else
+			{
+				while (!_is_end() && _cur_ch != '"' && _cur_ch != '\\')
+				{
+					buf.push_back(_cur_ch);
+					_get_nextch();
+				}
+			}
+		}
+
+		// 读取字符串的剩余部分（刚读过起始引号）到 _lex
+		void _scan_string()
+		{
+			_lex.kind = _lex_t::string;
+			if constexpr (_view_mode)
+			{
+				_in_place_str buf{ const_cast<_char_t*>(_pos) };
+				_parse_string_to(buf);
+				_lex.str = { buf.beg, buf.len };
+			}
+			else
+			{
+				if constexpr (sizeof(_char_t) == 1)
+				{
+					// 窗口内就能读到结尾引号且没有转义时直接引用窗口（读过引号不会补充输入而移动窗口）
+					const _char_t* run_end = _from_raw(simd::find_string_special(_raw(_pos), _raw(_end)));
+					if (run_end != _end && *run_end == '"' && (run_end + 1 != _end || !_read_func))
+					{
+						_lex.str = { _pos, static_cast<size_t>(run_end - _pos) };
+						_pos = run_end;
+						_cur_ch = '"';
+						_mark_node_start();
+						_get_nextch();
+						return;
+					}
+				}
+				_lex_buf.clear();
+				_parse_string_to(_lex_buf);
+				_lex.str = _lex_buf;
+			}
+		}
+
+		template<typename _buf_t>
+		void _parse_string_to(_buf_t& buf)
+		{
+			while (true)
+			{
+				_append_string_run(buf);
+				_mark_node_start();
+				if (_is_end())
+				{
+					// 错误 字符串未闭合
+					_throw_err(_origin::parse_string, _error::item_not_closed);
+					break;
+				}
+				else if (_cur_ch == '"')
+				{
+					_get_nextch();
+					break;
+				}
+				else if (_cur_ch == '\\')
+				{
+					_get_nextch();
+					char ch = 0;
+					switch (_cur_ch)
+					{
+					case '0':break;
+					case 'a':ch = '\a'; break;
+					case 'b':ch = '\b'; break;
+					case 'f':ch = '\f'; break;
+					case 'n':ch = '\n'; break;
+					case 'r':ch = '\r'; break;
+					case 't':ch = '\t'; break;
+					case '"':ch = '\"'; break;
+					case '\\':ch = '\\'; break;
+					case 'u':
+					{
+						// _get_nextch() 在 _parse_unicode_to 处进行
+						_parse_unicode_to(buf);
+						_get_nextch();
+						continue;
+						break;
+					}
+					default:
+						ch = _cur_ch;
+						_throw_err(
+							_origin::parse_string, _error::illegal_escape,
+							{ '\\',ch }
+						);
+						break;
+					}
+					buf.push_back(ch);
+				}
+				_get_nextch();
+			}
+		}
+
+		// 读取 true/false/null 到 _lex，未知的关键词报错并读为 null
+		void _scan_keyword()
+		{
+			_mark_node_start();
+			std::basic_string<_char_t> buf;
+			buf.push_back(_cur_ch);
+			_get_nextch();
+			while (_isalnum(_cur_ch) || _cur_ch == '_')
+			{
+				buf.push_back(_cur_ch);
+				_get_nextch();
+			}
+
+			_lex.kind = _lex_t::boolean;
+			if (buf == "true")_lex.boolean = true;
+			else if (buf == "false")_lex.boolean = false;
+			else
+			{
+				_lex.kind = _lex_t::null;
+				// 错误 未知的关键词 
+				if (buf != "null")_throw_err(_origin::parse_keyword, _error::unknown_keyword, buf);
+			}
+		}
+
+		// 读取下一个词法单元到 _lex
+		void _scan()
+		{
+			_lex.kind = _lex_t::delimiter;
+			_lex.delim = _end_delimiter;
+			if (_is_end())return;
+			while (!_is_end())
+			{
+				_skip_space();
+				if (_is_end())return;
+				_token_ofs = _cur_ofs();
+				switch (_cur_ch)
+				{
+				case '/':
+					if (_look_nextch() == '/' || _look_nextch() == '*')
+					{
+						_skip_comment();
+						continue;
+					}
+					else
+					{
+						// 错误 意外的标识符
+						_throw_err(
+							_origin::parse_comment,
+							_error::unexpected_item,
+							{ '{','[','/','\\','*',']','}','@',_look_nextch(),'\0' }
+						);
+					}
+					break;
+				case '"':
+				{
+					_get_nextch();
+					if (_skim)
+					{
+						_skip_string_body();
+						_lex.kind = _lex_t::null;
+						return;
+					}
+					_scan_string();
+					return;
+				}
+				case ',': case ':': case '[': case ']':	case '{': case '}':
+				{
+					_lex.delim = static_cast<parser_delimiter>(_cur_ch);
+					_get_nextch();
+					return;
+				}
+				default:
+
+					if (_skim && (_isalnum(_cur_ch) || _cur_ch == '-' || _cur_ch == '+'))
+					{
+						while (_isalnum(_cur_ch) || _cur_ch == '-' || _cur_ch == '+' || _cur_ch == '.' || _cur_ch == '_')_get_nextch();
+						_lex.kind = _lex_t::null;
+						return;
+					}
+					if (_isdigit(_cur_ch) || _cur_ch == '-' || _cur_ch == '+')
+					{
+						_scan_num();
+						return;
+					}
+					else if (_isalpha(_cur_ch))
+					{
+						_scan_keyword();
+						return;
+					}
+					_throw_err(
+						_origin::parse_delimiter,
+						_error::unexpected_item,
+						std::string("{[/\",:\\[\\]\\{\\}}@") + _cur_ch
+					);
+					_get_nextch();
+					_lex.delim = static_cast<parser_delimiter>(_cur_ch);
+					return;
+				}
+				break;
+			}
+			_lex.kind = _lex_t::null;
+		}
+		_json_t _parse_simple_node()
+		{
+			_scan();
+			return _lex_node();
+		}
+
+		// 跳过空白后读取下一个词法单元（token 机器使用，不构建结点）
+		void _lex_next()
+		{
+			_skip_space();
+			_mark_node_start();
+			_scan();
+		}
+
+		void _get_next_simple_node()
+		{
+			_skip_space();
+			_mark_node_start();
+			_cur_node = _parse_simple_node();
+		}
+
+		/*
+		* 读取一个值（容器会被完整读取）到 _cur_node
+		* 用显式的栈代替递归：_dom_stack 中是尚未读完的容器，读完的值由 _cur_node 交给上一层，
+		* 出错时的恢复方式与逐层递归时相同
+		*/
+		struct _dom_frame
+		{
+			_json_t value;
+			_str_t key; // 对象中正在读取的值的键
+		};
+		std::vector<_dom_frame> _dom_stack;
+
+		// _cur_node 是 '[' 或 '{' 时开始读取一个容器（嵌套过深时报错并跳过，当作 null）
+		bool _enter_container()
+		{
+			auto delimiter = _cur_node.get_if<parser_delimiter>();
+			if (!delimiter || (*delimiter != parser_delimiter::left_bracket && *delimiter != parser_delimiter::left_brace))return false;
+			bool is_arr = *delimiter == parser_delimiter::left_bracket;
+			_origin origin = is_arr ? _origin::parse_array : _origin::parse_object;
+			if (_max_depth && _dom_stack.size() >= _max_depth)
+			{
+				_throw_err(origin, _error::too_deep, std::to_string(_max_depth));
+				_skip_to_close(origin);
+				_cur_node = nullptr;
+				return false;
+			}
+			_dom_stack.push_back({ _new_node(is_arr ? json_value_t::array : json_value_t::object), _new_str() });
+			return true;
+		}
+
+		void _get_next_node()
+		{
+			_skip_space();
+			// 结点起始位置在 _get_next_simple_node 处更新
+			_cur_node = _parse_simple_node();
+			if (!_enter_container())return;
+
+			// 当前容器刚开始（true）还是刚读完一个子结点（false）
+			bool entering = true;
+			while (true)
+			{
+				_dom_frame& top = _dom_stack.back();
+				bool closed = false;
+				if (top.value.hold<typename _json_t::array_t>())
+				{
+					auto& arr = top.value.get<typename _json_t::array_t>();
+					if (entering)
+					{
+						_skip_space();
+						_cur_node = _parse_simple_node();
+						if (_enter_container())continue;
+					}
+					while (true)
+					{
+						if (_cur_node == parser_delimiter::right_bracket || _is_end())
+						{
+							closed = true;
+							break;
+						}
+						if (_cur_node.hold<parser_delimiter>())
+						{
+							// 错误 期望值
+							_throw_err(
+								_origin::parse_array,
+								_error::unexpected_item,
+								"<!delimiter>@" + _cur_node.dump()
+							);
+							_cur_node = nullptr;
+						}
+						arr.push_back(std::move(_cur_node));
+						_get_next_simple_node();
+						if (_cur_node == parser_delimiter::right_bracket)
+						{
+							closed = true;
+							break;
+						}
+						if (_cur_node != parser_delimiter::comma)
+						{
+							// 错误 期望 ','
+							_throw_err(
+								_origin::parse_array,
+								_error::unexpected_item,
+								"{,}@" + _cur_node.dump()
+							);
+							closed = true;
+							break;
+						}
+						_skip_space();
+						_cur_node = _parse_simple_node();
+						if (_enter_container())break;
+					}
+					if (closed && _cur_node != parser_delimiter::right_bracket)
+					{
+						_throw_err(_origin::parse_array, _error::item_not_closed);
+					}
+				}
+				else
+				{
+					auto& obj = top.value.get<typename _json_t::object_t>();
+					if (entering)_get_next_simple_node();
+					else
+					{
+						// 刚读完一个值
+						obj[std::move(top.key)] = std::move(_cur_node);
+						_get_next_simple_node();
+						if (_cur_node != parser_delimiter::right_brace)
+						{
+							if (_cur_node != parser_delimiter::comma)
+							{
+								// 错误 期望 ','
+								_throw_err(
+									_origin::parse_object,
+									_error::unexpected_item,
+									"{,}@" + _cur_node.dump()
+								);
+							}
+							_get_next_simple_node();
+						}
+					}
+					while (true)
+					{
+						if (_cur_node == parser_delimiter::right_brace || _is_end())
+						{
+							closed = true;
+							break;
+						}
+						if (!_cur_node.hold<_str_t>())
+						{
+							// 错误 期望 <string>
+							_throw_err(
+								_origin::parse_object,
+								_error::unexpected_item,
+								"<string>@" + _cur_node.dump()
+							);
+							_get_next_simple_node();
+							continue;
+						}
+						top.key = std::move(_cur_node.get<_str_t>());
+						_get_next_simple_node();
+						if (_cur_node != parser_delimiter::colon)
+						{
+							// 错误 期望 ':'
+							_throw_err(
+								_origin::parse_object,
+								_error::unexpected_item,
+								"{:}@" + _cur_node.dump()
+							);
+						}
+						_skip_space();
+						_cur_node = _parse_simple_node();
+						if (_enter_container())break;
+						if (_cur_node.hold<parser_delimiter>())
+						{
+							// 错误 期望值
+							_throw_err(
+								_origin::parse_object,
+								_error::unexpected_item,
+								"<!delimiter>@" + _cur_node.dump()
+							);
+							_cur_node = nullptr;
+						}
+						obj[std::move(top.key)] = std::move(_cur_node);
+						_get_next_simple_node();
+						if (_cur_node == parser_delimiter::right_brace)
+						{
+							closed = true;
+							break;
+						}
+						if (_cur_node != parser_delimiter::comma)
+						{
+							// 错误 期望 ','
+							_throw_err(
+								_origin::parse_object,
+								_error::unexpected_item,
+								"{,}@" + _cur_node.dump()
+							);
+						}
+						_get_next_simple_node();
+					}
+					if (closed && _cur_node != parser_delimiter::right_brace)
+					{
+						_throw_err(_origin::parse_object, _error::item_not_closed);
+					}
+				}
+
+				if (!closed)
+				{
+					// 进入了子容器
+					entering = true;
+					continue;
+				}
+				// 当前容器读完，交给上一层
+				_cur_node = std::move(_dom_stack.back().value);
+				_dom_stack.pop_back();
+				if (_dom_stack.empty())return;
+				entering = false;
+			}
+		}
+
+		/*
+		* 不递归地逐个读取 token（供 parse_sax 等使用）
+		* 用显式的栈记录所在的容器及其中的位置，出错时的恢复方式与 _get_next_node 相同，
+		* 但保证 start_xxx/end_xxx 总是成对出现（未闭合的容器在报错后也会产生 end_xxx）
+		*/
+		enum class _frame_state : uint8_t
+		{
+			arr_first, // 刚读过 '[' 或 ','
+			arr_after_value,
+			obj_first, // 刚读过 '{'
+			obj_colon, // 刚读过键
+			obj_after_value
+		};
+		std::vector<_frame_state> _frames;
+		_str_t _key;
+
+		json_token _open(_frame_state st, json_token tok)
+		{
+			if (_max_depth && _frames.size() >= _max_depth)
+			{
+				// 嵌套过深：报错并跳过该容器，当作 null
+				_origin origin = tok == json_token::start_array ? _origin::parse_array : _origin::parse_object;
+				_throw_err(origin, _error::too_deep, std::to_string(_max_depth));
+				_skip_to_close(origin);
+				_lex.kind = _lex_t::null;
+				return json_token::value;
+			}
+			_frames.push_back(st);
+			return tok;
+		}
+		json_token _close(json_token tok)
+		{
+			_frames.pop_back();
+			return tok;
+		}
+
+		// 容器内读到一个值（_lex）后的处理，parent 为容器读完该值后的状态
+		json_token _open_or_value(_frame_state parent, _origin origin)
+		{
+			_frames.back() = parent;
+			if (_lex_is(parser_delimiter::left_bracket))
+				return _open(_frame_state::arr_first, json_token::start_array);
+			if (_lex_is(parser_delimiter::left_brace))
+				return _open(_frame_state::obj_first, json_token::start_object);
+			if (_lex.kind == _lex_t::delimiter)
+			{
+				// 错误 期望值
+				_throw_err(
+					origin,
+					_error::unexpected_item,
+					"<!delimiter>@" + _lex_node().dump()
+				);
+				_lex.kind = _lex_t::null;
+			}
+			return json_token::value;
+		}
+
+		json_token _array_value()
+		{
+			if (_lex_is(parser_delimiter::right_bracket))
+				return _close(json_token::end_array);
+			if (!_lex_is(parser_delimiter::left_bracket)
+				&& !_lex_is(parser_delimiter::left_brace)
+				&& _is_end()
+				) {
+				_throw_err(_origin::parse_array, _error::item_not_closed);
+				return _close(json_token::end_array);
+			}
+			return _open_or_value(_frame_state::arr_after_value, _origin::parse_array);
+		}
+
+		json_token _object_key()
+		{
+			while (!_lex_is(parser_delimiter::right_brace) && !_is_end())
+			{
+				if (_lex.kind != _lex_t::string)
+				{
+					// 错误 期望 <string>
+					_throw_err(
+						_origin::parse_object,
+						_error::unexpected_item,
+						"<string>@" + _lex_node().dump()
+					);
+					_lex_next();
+					continue;
+				}
+				_frames.back() = _frame_state::obj_colon;
+				return json_token::key;
+			}
+			if (!_lex_is(parser_delimiter::right_brace))
+			{
+				_throw_err(_origin::parse_object, _error::item_not_closed);
+			}
+			return _close(json_token::end_object);
+		}
+
+		bool _is_number_node()const
+		{
+			switch (_cur_node.type())
+			{
+			case json_value_t::num_i32:
+			case json_value_t::num_ui32:
+			case json_value_t::num_i64:
+			case json_value_t::num_ui64:
+			case json_value_t::num_double:
+			case json_value_t::num_raw:
+				return true;
+			default:
+				return false;
+			}
+		}
+
+		// 以 tk 开头的值能否读入 _t
+		template<typename _t>
+		bool _bind_accepts(json_token tk)const
+		{
+			if constexpr (is_optional<_t>::value)
+			{
+				return (tk == json_token::value && _cur_node.type() == json_value_t::null)
+					|| _bind_accepts<typename _t::value_type>(tk);
+			}
+			else if constexpr (is_bound<_t>::value)return tk == json_token::start_object;
+			else if constexpr (is_vector<_t>::value)return tk == json_token::start_array;
+			else if constexpr (std::is_same_v<_t, _json_t>)return true;
+			else if constexpr (std::is_same_v<_t, bool>)return tk == json_token::value && _cur_node.hold<bool>();
+			else if constexpr (std::is_arithmetic_v<_t>)return tk == json_token::value && _is_number_node();
+			else return tk == json_token::value && _cur_node.hold<_str_t>();
+		}
+		template<typename _t>
+		static const char* _bind_expect()
+		{
+			if constexpr (is_optional<_t>::value)return _bind_expect<typename _t::value_type>();
+			else if constexpr (is_bound<_t>::value)return "<object>";
+			else if constexpr (is_vector<_t>::value)return "<array>";
+			else if constexpr (std::is_same_v<_t, bool>)return "<bool>";
+			else if constexpr (std::is_arithmetic_v<_t>)return "<number>";
+			else return "<string>";
+		}
+
+		/*
+		* 当前数字不能无损地读入 _t（超出范围或把小数读入整数）：报告错误
+		* 返回是否继续读取
+		*/
+		template<typename _t>
+		bool _bind_out_of_range()
+		{
+			std::string expect;
+			if constexpr (std::is_floating_point_v<_t>)expect = "<number within the range of float>";
+			else expect = "<integer in [" + std::to_string(+(std::numeric_limits<_t>::min)())
+				+ ", " + std::to_string(+std::numeric_limits<_t>::max()) + "]>";
+			_throw_err(_origin::bind_value, _error::unexpected_item, expect + "@" + _cur_node.dump());
+			return !_is_abort;
+		}
+
+		/*
+		* 类型不符：报告错误并跳过当前值（tk 为其第一个 token）
+		* 返回是否继续读取
+		*/
+		template<typename _t>
+		bool _bind_mismatch(json_token tk)
+		{
+			_throw_err(
+				_origin::bind_value,
+				_error::unexpected_item,
+				std::string(_bind_expect<_t>()) + "@" + (
+					tk == json_token::value ? _cur_node.dump()
+					: tk == json_token::start_object ? "{...}" : "[...]"
+				)
+			);
+			skip();
+			return !_is_abort;
+		}
+
+		// 把以 tk 开头的值读入 out，返回是否继续读取
+		template<typename _t>
+		bool _bind_read(_t& out, json_token tk)
+		{
+			if (tk == json_token::end || tk == json_token::abort)return false;
+			if (!_bind_accepts<_t>(tk))return _bind_mismatch<_t>(tk);
+
+			if constexpr (is_optional<_t>::value)
+			{
+				if (tk == json_token::value && _cur_node.type() == json_value_t::null)
+				{
+					out.reset();
+					return true;
+				}
+				if (!out)out.emplace();
+				return _bind_read(*out, tk);
+			}
+			else if constexpr (is_bound<_t>::value)
+			{
+				while ((tk = next()) == json_token::key)
+				{
+					bool ok = true;
+					bool found = visit_bound_field<_t>(_key, [&](const auto& f)
+						{
+							ok = _bind_read(out.*f.ptr, next());
+						});
+					if (!found)skip();
+					else if (!ok)return false;
+				}
+				return tk == json_token::end_object;
+			}
+			else if constexpr (is_vector<_t>::value)
+			{
+				using _elem_t = typename _t::value_type;
+				out.clear();
+				while ((tk = next()) != json_token::end_array)
+				{
+					if (!_bind_accepts<_elem_t>(tk))
+					{
+						// 不符的元素不加入
+						if (!_bind_mismatch<_elem_t>(tk))return false;
+						continue;
+					}
+					if constexpr (std::is_arithmetic_v<_elem_t> && !std::is_same_v<_elem_t, bool>)
+					{
+						// 超出范围的数字同样不加入
+						_elem_t v;
+						if (get_number(v))out.push_back(v);
+						else if (!_bind_out_of_range<_elem_t>())return false;
+						continue;
+					}
+					out.emplace_back();
+					if (!_bind_read(out.back(), tk))return false;
+				}
+				return true;
+			}
+			else if constexpr (std::is_same_v<_t, _json_t>)
+			{
+				switch (tk)
+				{
+				case json_token::start_array:
+				{
+					out.assign(json_value_t::array);
+					auto& arr = out.get<typename _json_t::array_t>();
+					while ((tk = next()) != json_token::end_array)
+					{
+						arr.emplace_back();
+						if (!_bind_read(arr.back(), tk))return false;
+					}
+					return true;
+				}
+				case json_token::start_object:
+				{
+					out.assign(json_value_t::object);
+					auto& obj = out.get<typename _json_t::object_t>();
+					while ((tk = next()) == json_token::key)
+					{
+						if (!_bind_read(obj[_key], next()))return false;
+					}
+					return tk == json_token::end_object;
+				}
+				default:
+					out = std::move(_cur_node);
+					return true;
+				}
+			}
+			else if constexpr (std::is_same_v<_t, bool>)
+			{
+				out = _cur_node.get<bool>();
+				return true;
+			}
+			else if constexpr (std::is_arithmetic_v<_t>)
+			{
+				return get_number(out) || _bind_out_of_range<_t>();
+			}
+			else
+			{
+				static_assert(std::is_assignable_v<_t&, const _str_t&>, "type is not bindable, use SJSON_BIND to describe it");
+				static_assert(_view_mode || !is_string_view<_t>::value,
+					"string_view members would dangle after parsing, use std::string or parse_into_in_place");
+				out = _cur_node.get<_str_t>();
+				return true;
+			}
+		}
+
+		/*
+		* 投影解析（见 parse_projection）用的指针前缀树，每个结点对应指针中的一个 token
+		*/
+		struct _proj_node
+		{
+			std::map<std::string, size_t, std::less<>> children; // token -> 子结点下标
+			bool whole = false; // 有指针在此结束：读取整个值
+		};
+
+		/**
+		 * @brief 把 JSON Pointer（RFC 6901）拆分为 token 并还原 "~0"、"~1"
+		 * @return ptr 是否为合法的指针（空串或以 '/' 开头）
+		 */
+		static bool _split_pointer(const std::string& ptr, std::vector<std::string>& out)
+		{
+			out.clear();
+			if (!ptr.empty() && ptr[0] != '/')return false;
+			size_t i = 0;
+			while (i < ptr.size())
+			{
+				size_t j = ptr.find('/', i + 1);
+				if (j == std::string::npos)j = ptr.size();
+				std::string tok = ptr.substr(i + 1, j - i - 1);
+				for (size_t k = 0; (k = tok.find('~', k)) != std::string::npos; ++k)
+				{
+					if (k + 1 < tok.size() && (tok[k + 1] == '0' || tok[k + 1] == '1'))
+						tok.replace(k, 2, tok[k + 1] == '0' ? "~" : "/");
+				}
+				out.push_back(std::move(tok));
+				i = j;
+			}
+			return true;
+		}
+
+		// 不解码地跳过下一个值，返回其第一个 token（容器已被整个跳过）
+		json_token _skim_next()
+		{
+			_skim = true;
+			json_token tk = next();
+			_skim = false;
+			if (tk == json_token::start_object || tk == json_token::start_array)skip();
+			return tk;
+		}
+
+		/*
+		* 按前缀树的结点 at 读取以 tk 开头的值中需要的部分，返回是否继续读取
+		* 值中没有请求的路径时 out 保持为 null（整个读取的结点除外）
+		*/
+		bool _project(const std::vector<_proj_node>& trie, size_t at, _json_t& out, json_token tk)
+		{
+			const _proj_node& nd = trie[at];
+			if (nd.whole)return _bind_read(out, tk);
+
+			if (tk == json_token::start_object)
+			{
+				using object_t = typename _json_t::object_t;
+				while ((tk = next()) == json_token::key)
+				{
+					auto it = nd.children.find(std::string_view(_key));
+					if (it == nd.children.end())
+					{
+						_skim_next();
+						continue;
+					}
+					// 与 _get_next_node 一样，重复的键取最后一个：后面的值覆盖或去掉前面读到的值，
+					// 因此读到所有键后也不能跳过对象的剩余部分（剩余的值仍只按括号匹配跳过）
+					_str_t key = _key;
+					_json_t child;
+					if (!_project(trie, it->second, child, next()))return false;
+					if (_has_projection(trie[it->second], child))
+					{
+						if (!out.hold<object_t>())out.assign(json_value_t::object);
+						out.get<object_t>()[key] = std::move(child);
+					}
+					else if (out.hold<object_t>())
+					{
+						out.get<object_t>().erase(key);
+						if (out.get<object_t>().empty())out.assign(json_value_t::null);
+					}
+				}
+				return tk == json_token::end_object;
+			}
+			if (tk == json_token::start_array)
+			{
+				using array_t = typename _json_t::array_t;
+				char buf[24];
+				size_t found = 0;
+				for (size_t i = 0; ; ++i)
+				{
+					auto it = nd.children.find(std::string_view(buf, std::to_chars(buf, buf + sizeof(buf), i).ptr - buf));
+					if (it == nd.children.end())
+					{
+						tk = _skim_next();
+						if (tk == json_token::end_array)return true;
+						if (tk == json_token::end || tk == json_token::abort)return false;
+						continue;
+					}
+					tk = next();
+					if (tk == json_token::end_array)return true;
+					_json_t child;
+					if (!_project(trie, it->second, child, tk))return false;
+					if (_has_projection(trie[it->second], child))
+					{
+						if (!out.hold<array_t>())out.assign(json_value_t::array);
+						auto& arr = out.get<array_t>();
+						arr.resize(i + 1); // 未请求的元素为 null
+						arr[i] = std::move(child);
+					}
+					// 下标不会重复，需要的元素都已读到时按括号匹配跳过数组的剩余部分
+					if (++found == nd.children.size())
+					{
+						_skip_container();
+						return !_is_abort;
+					}
+				}
+			}
+			// 值不是容器：请求的路径不存在
+			if (tk == json_token::end || tk == json_token::abort)return false;
+			return true;
+		}
+		// _project 读到的值中是否有请求的路径
+		static bool _has_projection(const _proj_node& nd, const _json_t& v)
+		{
+			return nd.whole || v.type() != json_value_t::null;
+		}
+
+		// 读取下一个 token，值与键只留在 _lex 中（parse_sax 直接使用）
+		json_token _next_lex_token()
+		{
+			while (true)
+			{
+				if (_is_abort)return json_token::abort;
+				if (_frames.empty())
+				{
+					_lex_next();
+					if (_lex_is(parser_delimiter::left_bracket))
+						return _open(_frame_state::arr_first, json_token::start_array);
+					if (_lex_is(parser_delimiter::left_brace))
+						return _open(_frame_state::obj_first, json_token::start_object);
+					if (_lex_is(_end_delimiter))
+						return _is_abort ? json_token::abort : json_token::end;
+					// 顶层多余的分隔符直接跳过（与 parse 相同）
+					if (_lex.kind == _lex_t::delimiter)continue;
+					return json_token::value;
+				}
+
+				switch (_frames.back())
+				{
+				case _frame_state::arr_first:
+					_lex_next();
+					return _array_value();
+				case _frame_state::arr_after_value:
+					_lex_next();
+					if (_lex_is(parser_delimiter::right_bracket))
+						return _close(json_token::end_array);
+					if (!_lex_is(parser_delimiter::comma) && !_lex_is(_end_delimiter))
+					{
+						// 错误 期望 ','
+						_throw_err(
+							_origin::parse_array,
+							_error::unexpected_item,
+							"{,}@" + _lex_node().dump()
+						);
+					}
+					if (!_lex_is(parser_delimiter::comma))
+					{
+						_throw_err(_origin::parse_array, _error::item_not_closed);
+						return _close(json_token::end_array);
+					}
+					_lex_next();
+					return _array_value();
+				case _frame_state::obj_first:
+					_lex_next();
+					return _object_key();
+				case _frame_state::obj_colon:
+					_lex_next();
+					if (!_lex_is(parser_delimiter::colon))
+					{
+						// 错误 期望 ':'
+						_throw_err(
+							_origin::parse_object,
+							_error::unexpected_item,
+							"{:}@" + _lex_node().dump()
+						);
+					}
+					_lex_next();
+					return _open_or_value(_frame_state::obj_after_value, _origin::parse_object);
+				case _frame_state::obj_after_value:
+					_lex_next();
+					if (_lex_is(parser_delimiter::right_brace))
+						return _close(json_token::end_object);
+					if (!_lex_is(parser_delimiter::comma))
+					{
+						// 错误 期望 ','
+						_throw_err(
+							_origin::parse_object,
+							_error::unexpected_item,
+							"{,}@" + _lex_node().dump()
+						);
+					}
+					_lex_next();
+					return _object_key();
+				}
+			}
+		}
+
+		// 读取下一个 token，读到值时构建 _cur_node，读到键时写入 _key
+		json_token _next_token()
+		{
+			json_token t = _next_lex_token();
+			if (t == json_token::value)_cur_node = _lex_node();
+			else if (t == json_token::key)
+			{
+				if constexpr (_view_mode)_key = _lex_string();
+				else _key.assign(_lex.str.data(), _lex.str.size());
+			}
+			return t;
+		}
+
+		// 跳过字符串的剩余部分（刚读过起始引号），不解码内容
+		void _skip_string_body()
+		{
+			while (!_is_end())
+			{
+				if constexpr (sizeof(_char_t) == 1)
+				{
+					_pos = _from_raw(simd::find_string_special(_raw(_pos), _raw(_end)));
+					_sync_cur_ch();
+					if (_is_end())break;
+				}
+				if (_cur_ch == '"')
+				{
+					_get_nextch();
+					return;
+				}
+				if (_cur_ch == '\\')_get_nextch();
 				_get_nextch();
-				bool comment_closed = false;
-				while (_cur_ch != end_flag)
+			}
+			_throw_err(_origin::parse_string, _error::item_not_closed);
+		}
+
+		/*
+		* 不解析内容，只按括号匹配跳过当前容器的剩余部分（刚读过它的起始括号）
+		* 括号种类不匹配等错误不会被检查
+		*/
+		void _skip_container()
+		{
+			_origin origin = _frames.back() < _frame_state::obj_first
+				? _origin::parse_array : _origin::parse_object;
+			_frames.pop_back();
+			_skip_to_close(origin);
+		}
+		// 按括号匹配跳到刚读过的起始括号所对应的结束括号之后，未闭合时以 origin 报错
+		void _skip_to_close(_origin origin)
+		{
+			size_t depth = 1;
+			while (!_is_end())
+			{
+				switch (_cur_ch)
+				{
+				case '"':
+					_get_nextch();
+					_skip_string_body();
+					continue;
+				case '/':
+					if (_look_nextch() == '/' || _look_nextch() == '*')
+					{
+						_skip_comment();
+						continue;
+					}
+					break;
+				case '[': case '{':
+					depth++;
+					break;
+				case ']': case '}':
+					if (--depth == 0)
+					{
+						_get_nextch();
+						return;
+					}
+					break;
+				}
+				_get_nextch();
+			}
+			if (!_is_abort)_throw_err(origin, _error::item_not_closed);
+		}
+
+		template<typename _handler_t>
+		bool _dispatch_value(_handler_t& h)
+		{
+			switch (_lex.kind)
+			{
+			case _lex_t::string: return h.string(_lex.str);
+			case _lex_t::raw_number:
+				_lex.num = _make_number(_lex.str.data(), _lex.str.data() + _lex.str.size(), !_lex.integral);
+				[[fallthrough]];
+			case _lex_t::number:
+				switch (_lex.num.type)
+				{
+				case json_value_t::num_i32: case json_value_t::num_i64: return h.number_int64(_lex.num.i);
+				case json_value_t::num_ui64: return h.number_uint64(_lex.num.u);
+				default: return h.number_double(_lex.num.d);
+				}
+			case _lex_t::boolean: return h.boolean(_lex.boolean);
+			default: return h.null();
+			}
+		}
+
+		json_token _last_token = json_token::end;
+
+		/*
+		* 推送解析：每次从 token 开头开始读取，读到已有输入的末尾而 token 可能不完整时
+		* 退回到开头（连同 _frames 与暂存的错误），等待 feed 补充输入后重新读取
+		*/
+		struct _push_level
+		{
+			_json_t value;
+			_str_t key;
+		};
+		std::vector<_push_level> _push_stack; // 正在构建的各层容器（与 _dom_stack 相同，只在用到时分配）
+		size_t _push_scanned = _npos; // 上次中断时已有输入的长度（相对 _beg），没有中断的 token 时为 _npos
+
+		// 读到已有输入的末尾时，结果为 t 的 token 是否可能不完整
+		bool _push_incomplete(json_token t)const
+		{
+			if (!_starved && _pos != _end)return false;
+			if (!_pending_errs.empty())return true;
+			switch (t)
+			{
+			case json_token::start_object: case json_token::end_object:
+			case json_token::start_array: case json_token::end_array:
+			case json_token::key:
+				return false;
+			case json_token::value:
+				// 字符串以引号结束，数字与关键字则要看到下一个字符才能确定结束
+				return _lex.kind != _lex_t::string;
+			default:
+				return true;
+			}
+		}
+
+		// 中断的 token 只有在新输入中出现可能结束它的字符时才值得重新读取（避免长字符串被反复扫描）
+		bool _push_worth_retry()
+		{
+			if (_push_scanned == _npos || _token_ofs < _cur_ofs())return true;
+			const _char_t* from = _beg + _push_scanned;
+			_push_scanned = _end - _beg;
+			_char_t first = _beg[_token_ofs - _base_ofs];
+			if (first == '"')return std::find(from, _end, '"') != _end;
+			if (_isalnum(first) || first == '-' || first == '+')
+			{
+				return std::find_if(from, _end, [](_char_t ch)
+				{
+					return !(_isalnum(ch) || ch == '.' || ch == '-' || ch == '+');
+				}) != _end;
+			}
+			return true;
+		}
+
+		json_feed_status _run_push()
+		{
+			while (true)
+			{
+				if (_is_abort)return json_feed_status::abort;
+				_skip_space();
+				const _char_t* start = _pos;
+				size_t depth = _frames.size();
+				_frame_state top = depth ? _frames.back() : _frame_state();
+				_starved = false;
+
+				json_token t = _next_token();
+				if (_feeding && _push_incomplete(t))
+				{
+					_pos = start;
+					_cur_ch = _pos != _end ? *_pos : end_flag;
+					_frames.resize(depth);
+					if (depth)_frames.back() = top;
+					_pending_errs.clear();
+					_push_scanned = _end - _beg;
+					return json_feed_status::need_more;
+				}
+				_push_scanned = _npos;
+				for (const auto& x : _pending_errs)
+				{
+					_report_err(x.pos, x.origin, x.e, x.msg);
+					if (_is_abort)break;
+				}
+				_pending_errs.clear();
+				if (_is_abort)return json_feed_status::abort;
+
+				switch (t)
+				{
+				case json_token::end:
+					return _feeding ? json_feed_status::need_more : json_feed_status::end;
+				case json_token::abort:
+					return json_feed_status::abort;
+				case json_token::start_object:
+					_push_stack.push_back({ _new_node(json_value_t::object), _new_str() });
+					continue;
+				case json_token::start_array:
+					_push_stack.push_back({ _new_node(json_value_t::array), _new_str() });
+					continue;
+				case json_token::key:
+					_push_stack.back().key = std::move(_key);
+					continue;
+				case json_token::end_object: case json_token::end_array:
+					_cur_node.swap(_push_stack.back().value);
+					_push_stack.pop_back();
+					break;
+				default:
+					break;
+				}
+
+				// 得到了一个完整的值（_cur_node）
+				if (_push_stack.empty())return json_feed_status::done;
+				auto& parent = _push_stack.back();
+				if (parent.value.hold<typename _json_t::array_t>())
+					parent.value.get<typename _json_t::array_t>().emplace_back().swap(_cur_node);
+				else
+					parent.value.get<typename _json_t::object_t>()[std::move(parent.key)].swap(_cur_node);
+			}
+		}
+
+		/*
+		* 并行解析（见 parse_parallel）
+		* 输入按 64 字节对齐等分为若干段，各段的预扫描与元素解析分别在各自的线程中进行
+		*/
+		static constexpr size_t _parallel_min_chunk = 1 << 20;
+		static constexpr size_t _npos = static_cast<size_t>(-1);
+
+		struct _chunk_scan
+		{
+			bool in_str = false; // 段首是否位于字符串中
+			bool odd_quotes = false; // 段内未转义引号的个数是否为奇数
+			bool comment = false; // 字符串外是否出现 '/'
+			int64_t depth = 0; // 段首的括号深度
+			int64_t delta = 0; // 段内括号深度的变化
+			int64_t min_delta = std::numeric_limits<int64_t>::max(); // 段内各闭括号之后深度（相对段首）的最小值
+			size_t min_pos = _npos; // 首次到达最小值的闭括号的位置
+			size_t split = _npos; // 段内第一个位于根数组中的 ','
+		};
+
+		/**
+		 * \brief 以 64 字节为一块扫描 [s + b, s + e)，对每块调用 f(块起始偏移, 掩码, 字符串外的有效位)
+		 * \param in_str 段首是否位于字符串中
+		 * \param f 返回 false 时停止扫描
+		 */
+		template<typename _func_t>
+		static void _scan_blocks(const char* s, size_t b, size_t e, bool in_str, _func_t&& f)
+		{
+			// 段首之前的连续反斜杠个数为奇数时段首字符被转义
+			uint64_t esc_carry = 0;
+			for (size_t k = b; k > 0 && s[k - 1] == '\\'; --k)esc_carry ^= 1;
+			uint64_t str_carry = in_str ? ~uint64_t(0) : 0;
+			for (size_t i = b; i < e; i += 64)
+			{
+				simd::block_masks m;
+				uint64_t valid = ~uint64_t(0);
+				if (e - i >= 64)m = simd::classify_block(s + i);
+				else
+				{
+					char tmp[64];
+					std::memset(tmp, ' ', sizeof(tmp));
+					std::memcpy(tmp, s + i, e - i);
+					m = simd::classify_block(tmp);
+					valid = (uint64_t(1) << (e - i)) - 1;
+				}
+				m.quote &= ~structural_index::_escaped_of(m.backslash, esc_carry);
+				uint64_t in = simd::prefix_xor(m.quote) ^ str_carry;
+				str_carry = uint64_t(0) - (in >> 63);
+				if (!f(i, m, ~in & valid))return;
+			}
+		}
+
+		// 第二遍：统计段内的括号深度变化（需已知 in_str）
+		static void _scan_depth(const char* s, size_t b, size_t e, _chunk_scan& c)
+		{
+			_scan_blocks(s, b, e, c.in_str, [&](size_t i, const simd::block_masks& m, uint64_t out)
+			{
+				if (m.slash & out)
+				{
+					c.comment = true;
+					return false;
+				}
+				for (uint64_t ops = m.op & out; ops; ops &= ops - 1)
+				{
+					size_t at = i + std::countr_zero(ops);
+					char ch = s[at];
+					if (ch == '[' || ch == '{')c.delta++;
+					else if ((ch == ']' || ch == '}') && --c.delta < c.min_delta)
+					{
+						c.min_delta = c.delta;
+						c.min_pos = at;
+					}
+				}
+				return true;
+			});
+		}
+
+		// 第三遍：从段首开始找第一个位于第 1 层的 ','（需已知 in_str 与 depth）
+		static void _scan_split(const char* s, size_t b, size_t e, _chunk_scan& c)
+		{
+			int64_t depth = c.depth;
+			_scan_blocks(s, b, e, c.in_str, [&](size_t i, const simd::block_masks& m, uint64_t out)
+			{
+				for (uint64_t ops = m.op & out; ops; ops &= ops - 1)
+				{
+					size_t at = i + std::countr_zero(ops);
+					char ch = s[at];
+					if (ch == '[' || ch == '{')depth++;
+					else if (ch == ']' || ch == '}')depth--;
+					else if (ch == ',' && depth == 1)
+					{
+						c.split = at;
+						return false;
+					}
+				}
+				return true;
+			});
+		}
+
+		// 只解析 [pos, end) 的片段（begin 为整个输入的开头，用于报错时计算行列号）
+		struct _range_t {};
+		parser(_range_t, const _char_t* begin, const _char_t* pos, const _char_t* end, const json_parse_error_callback_f& f)
+		{
+			static_assert(!_view_mode, "in-place parsing needs a writable buffer");
+			_err_callback = f;
+			_beg = begin;
+			_pos = pos;
+			_end = end;
+			_cur_ch = _pos != _end ? *_pos : end_flag;
+		}
+
+		/**
+		 * \brief 解析片段中以 ',' 分隔的根数组元素
+		 * \param last 是否为根数组的最后一段（允许以 ',' 结尾或为空）
+		 * \return 片段是否恰好由若干个元素组成（出现空元素等情况时返回 false，由串行解析报告错误）
+		 */
+		bool _parse_array_items(typename _json_t::array_t& out, bool last, const std::atomic<bool>& failed)
+		{
+			_get_next_node();
+			if (_cur_node == _end_delimiter)return last && _pos == _end;
+			while (!failed)
+			{
+				if (_cur_node.hold<parser_delimiter>())return false;
+				out.emplace_back().swap(_cur_node);
+				_get_next_simple_node();
+				if (_cur_node == _end_delimiter)return _pos == _end;
+				if (_cur_node != parser_delimiter::comma)return false;
+				_get_next_node();
+				if (_cur_node == _end_delimiter)return last && _pos == _end;
+			}
+			return false;
+		}
+
+		template<typename _func_t>
+		static void _run_parallel(size_t n, _func_t&& f)
+		{
+			std::vector<std::thread> workers;
+			workers.reserve(n - 1);
+			for (size_t k = 1; k < n; ++k)workers.emplace_back(f, k);
+			f(size_t(0));
+			for (auto& t : workers)t.join();
+		}
+
+		/**
+		 * \brief 在 s 中找出根数组的切分位置
+		 * \return 根数组的 '['、各切分处的 ','、根数组的 ']' 的位置，不能并行解析时返回空
+		 */
+		static std::vector<size_t> _find_splits(const char* s, size_t n, size_t chunks)
+		{
+			std::vector<size_t> res;
+			size_t first = 0, last = n;
+			while (first < n && _isspace(s[first]))first++;
+			while (last > first && _isspace(s[last - 1]))last--;
+			if (last - first < 2 || s[first] != '[' || s[last - 1] != ']')return res;
+
+			std::vector<size_t> bound(chunks + 1);
+			for (size_t k = 0; k < chunks; ++k)bound[k] = n / chunks * k / 64 * 64;
+			bound[chunks] = n;
+
+			std::vector<_chunk_scan> scan(chunks);
+			_run_parallel(chunks, [&](size_t k)
+			{
+				bool odd = false;
+				_scan_blocks(s, bound[k], bound[k + 1], false, [&](size_t, const simd::block_masks& m, uint64_t)
+				{
+					odd ^= std::popcount(m.quote) & 1;
+					return true;
+				});
+				scan[k].odd_quotes = odd;
+			});
+			for (size_t k = 1; k < chunks; ++k)
+				scan[k].in_str = scan[k - 1].in_str ^ scan[k - 1].odd_quotes;
+			if (scan.back().in_str ^ scan.back().odd_quotes)return res;
+
+			_run_parallel(chunks, [&](size_t k) { _scan_depth(s, bound[k], bound[k + 1], scan[k]); });
+			for (size_t k = 0; k < chunks; ++k)
+			{
+				if (scan[k].comment)return res;
+				if (k)scan[k].depth = scan[k - 1].depth + scan[k - 1].delta;
+				if (k && scan[k].depth < 1 && bound[k] < last)return res;
+				// 根数组只能在最后一个字符处闭合
+				if (scan[k].min_pos == _npos)continue;
+				int64_t low = scan[k].depth + scan[k].min_delta;
+				if (low < 0 || (low == 0 && scan[k].min_pos != last - 1))return res;
+			}
+			if (scan.back().depth + scan.back().delta != 0)return res;
+
+			_run_parallel(chunks - 1, [&](size_t k) { _scan_split(s, bound[k + 1], bound[k + 2], scan[k + 1]); });
+			res.push_back(first);
+			for (size_t k = 1; k < chunks; ++k)
+			{
+				if (scan[k].split != _npos && scan[k].split > res.back() && scan[k].split < last - 1)
+					res.push_back(scan[k].split);
+			}
+			res.push_back(last - 1);
+			return res;
+		}
+
+		// 正在解析流（解析结束后需要将多读的字符退回）
+		std::istream* _stream = nullptr;
+
+	public:
+
+		// 构造时只设置输入而不解析
+		struct defer_t {};
+		static constexpr defer_t defer{};
+
+		// 构造推送解析器（见 feed）
+		struct push_t {};
+		static constexpr push_t push{};
+
+		/**
+		 * @brief 推送解析：追加一段输入并继续解析，可以在字符串、数字或容器的中间断开
+		 * @param s 新的输入（调用返回后不再被引用）
+		 * @param n 新输入的长度，为 0 时只继续解析已有的输入（例如在 done 之后读取下一个值）
+		 * @return need_more：已有输入不足以完成一个值；done：完成了一个顶层值，可用 result() 取得，
+		 *         剩余的输入留待下一次调用；abort：错误回调要求中止
+		 */
+		json_feed_status feed(const _char_t* s, size_t n)
+		{
+			if (n && _feeding)
+			{
+				// 已解析的部分超过一半时丢弃
+				size_t pos = _pos - _beg;
+				size_t drop = _utf8_keep(_pos) - _beg;
+				if (drop && drop >= static_cast<size_t>(_end - _beg) / 2)
+				{
+					_discard_before(_beg + drop);
+					_read_buf.erase(_read_buf.begin(), _read_buf.begin() + drop);
+					if (_push_scanned != _npos)_push_scanned -= drop;
+					pos -= drop;
+				}
+				_read_buf.insert(_read_buf.end(), s, s + n);
+				_beg = _read_buf.data();
+				_pos = _beg + pos;
+				_end = _beg + _read_buf.size();
+				_cur_ch = *_pos;
+				if constexpr (sizeof(_char_t) == 1)
+				{
+					if (_check_utf8 && !_check_utf8_window(false) && _is_abort)return json_feed_status::abort;
+				}
+				if (!_push_worth_retry())return json_feed_status::need_more;
+			}
+			return _run_push();
+		}
+		json_feed_status feed(std::basic_string_view<_char_t> s)
+		{
+			return feed(s.data(), s.size());
+		}
+
+		/**
+		 * @brief 推送解析：声明输入已经结束，并解析剩余的输入（未闭合的容器等会报告错误）
+		 * @return done：完成了一个顶层值（可继续调用 finish 读取后面的值）；end：没有更多的值；abort：错误回调要求中止
+		 */
+		json_feed_status finish()
+		{
+			if (_feeding)
+			{
+				_feeding = false;
+				_push_scanned = _npos;
+				_cur_ch = _pos != _end ? *_pos : end_flag;
+				if constexpr (sizeof(_char_t) == 1)
+				{
+					if (_check_utf8)_check_utf8_window(true);
+				}
+			}
+			return _run_push();
+		}
+
+		/**
+		 * @brief 以事件方式解析剩余的全部输入，不构建 json 树
+		 * @param h 事件处理器，需提供以下成员函数（均返回 bool，返回 false 时停止解析）：
+		 *   start_object() end_object() start_array() end_array() key(std::basic_string_view<string_char_t>)
+		 *   string(std::basic_string_view<string_char_t>) number_int64(int64_t) number_uint64(uint64_t) number_double(double)
+		 *   boolean(bool) null()
+		 *   key、string 的参数指向输入或解析器内部的缓冲区，只在回调期间有效；解析过程中不为各个值构建 json 结点
+		 * @return 是否解析到了输入结尾（处理器返回 false 或错误回调要求中止时返回 false）
+		 */
+		template<typename _handler_t>
+		bool parse_sax(_handler_t& h)
+		{
+			while (true)
+			{
+				bool go_on = true;
+				switch (_next_lex_token())
+				{
+				case json_token::end: return true;
+				case json_token::abort: return false;
+				case json_token::start_object: go_on = h.start_object(); break;
+				case json_token::end_object: go_on = h.end_object(); break;
+				case json_token::start_array: go_on = h.start_array(); break;
+				case json_token::end_array: go_on = h.end_array(); break;
+				case json_token::key: go_on = h.key(_lex.str); break;
+				case json_token::value: go_on = _dispatch_value(h); break;
+				}
+				if (!go_on)return false;
+			}
+		}
+
+		/*
+		* 游标：用 defer 构造后逐个调用 next() 读取 token，
+		* 读到 key 后可用 key() 取得键，读到 value 后可用 value()/get_number() 取得值，
+		* 不需要的值可用 skip() 直接跳过
+		*/
+
+		/**
+		 * @brief 读取下一个 token
+		 * @return token 种类，输入结束时为 json_token::end
+		 */
+		json_token next()
+		{
+			return _last_token = _next_token();
+		}
+
+		/**
+		 * @brief 跳过当前值：刚读到 start_object/start_array 时跳过整个容器（不解析其中内容），
+		 *        刚读到 key 时跳过该键对应的值，其他情况下不做任何事
+		 */
+		void skip()
+		{
+			if (_last_token == json_token::key)next();
+			if (_last_token == json_token::start_object || _last_token == json_token::start_array)
+			{
+				_skip_container();
+				_last_token = _last_token == json_token::start_object
+					? json_token::end_object : json_token::end_array;
+			}
+		}
+
+		// 上一次 next() 的结果
+		json_token token()const { return _last_token; }
+		// 当前所在容器的层数
+		size_t depth()const { return _frames.size(); }
+		// 上一个读到的键
+		const _str_t& key()const { return _key; }
+		_str_t& key() { return _key; }
+		// 上一个读到的值（字符串、数字、布尔或 null）
+		const _json_t& value()const { return _cur_node; }
+		_json_t& value() { return _cur_node; }
+
+		/**
+		 * @brief 以数值类型 _t 读取当前的数字值（规则见 _sjson_detail::number_convert）
+		 * @return 是否读取成功：当前值不是数字、读为整数类型时不是整数、或超出 _t 的范围时返回 false，out 保持不变
+		 */
+		template<typename _t>
+		bool get_number(_t& out)const
+		{
+			switch (_cur_node.type())
+			{
+			case json_value_t::num_i32: return number_convert(_cur_node.get<int32_t>(), out);
+			case json_value_t::num_i64: return number_convert(_cur_node.get<int64_t>(), out);
+			case json_value_t::num_ui32: return number_convert(_cur_node.get<uint32_t>(), out);
+			case json_value_t::num_ui64: return number_convert(_cur_node.get<uint64_t>(), out);
+			case json_value_t::num_double: return number_convert(_cur_node.get<double>(), out);
+			case json_value_t::num_raw: return raw_number_to(_cur_node.get<typename _json_t::raw_number_t>(), out);
+			default: return false;
+			}
+		}
+		/**
+		 * @brief 以数值类型 _t 读取当前的数字值
+		 * @return 转换后的值，不能读取（见上）时抛出 json_error
+		 */
+		template<typename _t>
+		_t get_number()const
+		{
+			_t res{};
+			if (get_number(res))return res;
+			if (!_is_number_node())
+				_JSON_THROW(std::string("get_number on json::") + json_type_name(_cur_node.type()), 1);
+			_JSON_THROW("number " + _cur_node.dump() + " is out of range or not an integer", 0);
+		}
+		/**
+		 * @brief 把下一个值直接读入 out（类型要求见 SJSON_BIND），不构建 json 树
+		 *        对象中未绑定的键被跳过；类型不符时报告 bind_value 错误并跳过该值，对应成员保持不变
+		 * @return 是否读完了整个值（输入提前结束或中止时返回 false）
+		 */
+		template<typename _t>
+		bool read_to(_t& out)
+		{
+			static_assert(std::is_same_v<_char_t, char>, "binding only supports char input");
+			json_token tk = next();
+			return _bind_read(out, tk);
+		}
+		/**
+		 * @brief 投影解析：只解析 pointers（JSON Pointer，RFC 6901）所指的值，其余部分不解码，
+		 *        容器按括号匹配整个跳过，需要的元素都读到后数组的剩余部分也直接跳过
+		 * @param pointers 指针字符串（也可以是能转换为 std::string 的类型，如 hpjson::json_pointer）
+		 * @return 只包含所请求路径的 json（路径上的容器只含所需的成员，数组中未请求的元素为 null；
+		 *         不存在的路径不出现；非法的指针被忽略；对象中重复的键与 parse 一样取最后一个）
+		 */
+		template<typename _ptr_t>
+		_json_t parse_projection(const std::vector<_ptr_t>& pointers)
+		{
+			std::vector<_proj_node> trie(1);
+			std::vector<std::string> toks;
+			for (const auto& p : pointers)
+			{
+				if (!_split_pointer(std::string(p), toks))continue;
+				size_t at = 0;
+				for (auto& tok : toks)
 				{
-					_cur_node_start_pos = _cur_pos;
-					if (_cur_ch == '*')
+					if (trie[at].whole)break;
+					auto it = trie[at].children.find(tok);
+					if (it != trie[at].children.end())
 					{
-						if (_match_ch('/'))
+						at = it->second;
+						continue;
+					}
+					// 先记下新结点的下标：emplace_back 可能使 trie 重新分配，it 随之失效
+					size_t child = trie.size();
+					trie[at].children.emplace(std::move(tok), child);
+					trie.emplace_back();
+					at = child;
+				}
+				trie[at].whole = true;
+				trie[at].children.clear();
+			}
+
+			_json_t res;
+			if (trie.size() > 1 || trie[0].whole)_project(trie, 0, res, next());
+			return res;
+		}
+
+		/**
+		 * @brief 流式读取下一个顶层值（NDJSON 或以空白分隔的多个 json），
+		 *        只保留当前这一个值，输入缓冲区在各值之间复用
+		 * @return 指向读到的值的指针（下一次调用前有效，可以修改或移走），输入结束或中止时返回 nullptr
+		 */
+		_json_t* next_value()
+		{
+			while (!_is_abort)
+			{
+				_get_next_node();
+				if (_cur_node == _end_delimiter)break;
+				// 顶层多余的分隔符直接跳过（与 parse 相同）
+				if (_cur_node.hold<parser_delimiter>())continue;
+				return &_cur_node;
+			}
+			return nullptr;
+		}
+
+		/**
+		 * @brief 用多个线程解析根为数组的单个大 json（只切分根数组）
+		 *        输入不是单个数组、含注释或有任何错误时退化为串行解析，错误只由串行解析报告
+		 * @param threads 线程数，为 0 时使用硬件线程数
+		 * @return 解析结果（与串行解析 parse() 的结果相同）
+		 */
+		static _json_t parse_parallel(
+			const _char_t* s, size_t n, size_t threads = 0,
+			const json_parse_error_callback_f& f = defult_parse_err_callback
+		)
+		{
+			_json_t res;
+			if constexpr (sizeof(_char_t) == 1)
+			{
+				if (!threads)threads = std::max(1u, std::thread::hardware_concurrency());
+				size_t chunks = (std::min)(threads, n / _parallel_min_chunk);
+				std::vector<size_t> splits;
+				if (chunks > 1)splits = _find_splits(_raw(s), n, chunks);
+				if (splits.size() > 2)
+				{
+					size_t parts = splits.size() - 1;
+					std::vector<typename _json_t::array_t> items(parts);
+					std::atomic<bool> failed = false;
+					auto on_err = [&failed](uint32_t, uint32_t, json_error_origin, json_parse_error, const std::string&)
+					{
+						failed = true;
+						return json_callback_ret::abort;
+					};
+					size_t workers = (std::min)(parts, threads);
+					_run_parallel(workers, [&](size_t k)
+					{
+						for (size_t i = k; i < parts && !failed; i += workers)
 						{
-							_get_nextch();
-							comment_closed = true;
-							break;
+							parser p(_range_t{}, s, s + splits[i] + 1, s + splits[i + 1], on_err);
+							if (!p._parse_array_items(items[i], i + 1 == parts, failed))failed = true;
+						}
+					});
+					if (!failed)
+					{
+						res.assign(json_value_t::array);
+						auto& arr = res.get<typename _json_t::array_t>();
+						size_t total = 0;
+						for (auto& part : items)total += part.size();
+						arr.resize(total);
+						size_t at = 0;
+						for (auto& part : items)
+						{
+							for (auto& j : part)arr[at++].swap(j);
 						}
+						return res;
 					}
-					_get_nextch();
 				}
-				if (!comment_closed)
+			}
+			parser p(s, n, f);
+			res.swap(p._cur_node);
+			return res;
+		}
+
+		/**
+		 * \brief 设置之后解析时使用的字符串池（仅原地解析模式）：
+		 *        长度不超过 max_len 的字符串与键放入 pool，结果中的这些字符串引用 pool 而不是输入缓冲区
+		 *        max_len 为 -1 时结果完全不引用输入，解析后即可复用输入缓冲区
+		 * \param pool 为 nullptr 时不使用字符串池
+		 */
+		void set_string_pool(basic_string_pool<_char_t>* pool, size_t max_len = 32)
+		{
+			static_assert(_view_mode, "string pool is only used by in-place parsing");
+			_pool = pool;
+			_pool_max_len = max_len;
+		}
+
+		/**
+		 * \brief 限制之后解析时容器的嵌套层数（对 parse 与逐个读取 token 的接口都有效），
+		 *        超过时报告 too_deep 错误，该容器按括号匹配跳过并当作 null
+		 * \param n 最大层数（默认为 _default_max_depth），为 0 时不限制
+		 */
+		void set_max_depth(size_t n)
+		{
+			_max_depth = n;
+		}
+
+		/**
+		 * \brief 设置之后解析时新建的字符串与容器所用的内存资源（仅 pmr 的 json），
+		 *        例如请求级的 monotonic_buffer_resource：整个结果都从它分配，可随它一次释放
+		 */
+		void set_memory_resource(std::pmr::memory_resource* res)
+		{
+			static_assert(_json_t::uses_pmr, "memory resources need a pmr json");
+			_res = res;
+			// 赋值不会改变 std::pmr 字符串与 pmr json 的内存资源，需要重新构造
+			std::destroy_at(&_key);
+			std::construct_at(&_key, _new_str());
+			std::destroy_at(&_cur_node);
+			std::construct_at(&_cur_node, _new_node(json_value_t::null));
+		}
+
+		/**
+		 * \brief 之后解析的数字是否只保存原文（json_value_t::num_raw，见 basic_raw_number）：
+		 *        不做任何转换，第一次以数值类型读取时才转换，dump 时原样写回
+		 */
+		void set_raw_numbers(bool raw)
+		{
+			_raw_numbers = raw;
+		}
+
+		/**
+		 * \brief 校验尚未读取的输入是否为合法的 UTF-8（应在构造或 reset 后、开始解析前调用），
+		 *        不合法时以 validate_utf8、invalid_utf8 报告第一个不合法序列的位置。
+		 *        流与推送输入在之后每次读入新的输入时继续校验（直到 reset），到输入结束时仍不完整的序列也不合法
+		 * \return 目前已有的输入是否合法
+		 */
+		bool validate_utf8()
+		{
+			static_assert(sizeof(_char_t) == 1, "UTF-8 validation needs a byte input");
+			_utf8_ofs = _cur_ofs();
+			_check_utf8 = _read_func || _feeding;
+			return _check_utf8_window(!_check_utf8 || _read_eof);
+		}
+
+		/**
+		 * \brief 丢弃输入与解析状态（包括上次的结果），以便解析下一份输入。
+		 *        错误回调、set_max_depth 等设置保持不变，各缓冲区（结构索引、读取窗口、栈等）保留已分配的容量；
+		 *        推送解析器仍为推送模式
+		 */
+		void reset()
+		{
+			if (_stream)_unread_to(*_stream);
+			_stream = nullptr;
+			_beg = _pos = _end = nullptr;
+			_cur_ch = end_flag;
+			_read_func = nullptr;
+			_read_buf.clear();
+			_read_eof = false;
+			_base_ofs = 0;
+			_base_line = 0;
+			_base_line_beg = 0;
+			_cur_node_start = 0;
+			_cur_node_start_pos = {};
+			_cur_node_start_resolved = true;
+			_cur_node = _json_t();
+			_token_ofs = 0;
+			_skim = false;
+			_is_abort = false;
+			_starved = false;
+			_feeding = _push_mode;
+			_pending_errs.clear();
+			_dom_stack.clear();
+			_frames.clear();
+			_key = _str_t();
+			_last_token = json_token::end;
+			_push_stack.clear();
+			_push_scanned = _npos;
+			_check_utf8 = false;
+		}
+		/**
+		 * \brief 把各项设置恢复为默认值：错误回调、set_max_depth、
+		 *        set_string_pool、set_memory_resource、set_raw_numbers（输入与解析状态不变）
+		 */
+		void reset_settings()
+		{
+			_err_callback = defult_parse_err_callback;
+			_max_depth = _default_max_depth;
+			_raw_numbers = false;
+			if constexpr (_view_mode)set_string_pool(nullptr, 0);
+			if constexpr (_json_t::uses_pmr)
+			{
+				if (_res != std::pmr::get_default_resource())set_memory_resource(std::pmr::get_default_resource());
+			}
+		}
+		/**
+		 * \brief reset 后以 s 为新的输入（与 defer 构造相同，不立即解析）
+		 */
+		void reset(const _char_t* s, size_t n)
+		{
+			static_assert(!_view_mode, "in-place parsing needs a writable buffer");
+			reset();
+			_set_input(s, n);
+		}
+		void reset(_char_t* s, size_t n)
+		{
+			reset();
+			_set_input(s, n);
+		}
+		void reset(std::basic_string_view<_char_t> s)
+		{
+			reset(s.data(), s.size());
+		}
+		void reset(std::istream& is)
+		{
+			static_assert(!_view_mode, "in-place parsing needs a writable buffer");
+			reset();
+			std::istream::sentry guard(is, true);
+			_set_input(guard ? _make_stream_reader(is) : read_f());
+			if (guard)_stream = &is;
+		}
+
+		void set_error_callback(const json_parse_error_callback_f& f)
+		{
+			_err_callback = f;
+		}
+
+		void parse(size_t maxn = 0)
+		{
+			_json_t j = _new_node(json_value_t::null);
+			_get_next_node();
+
+			if (maxn != 1) // 如果只读一个就不跳过空白（从 cin 读入完一个后不会继续等待）
+				_skip_space(); // 防止结束后有空白导致 _is_end() 返回 false
+			if (_is_end() || maxn == 1)
+			{
+				j.assign(std::move(_cur_node));
+			}
+			else
+			{
+				j.assign(json_value_t::array);
+				j.push_back(std::move(_cur_node));
+
+				while (!_is_end())
 				{
-					// 错误 注释未闭合
-					_throw_err(_origin::parse_comment, _error::item_not_closed);
+					if (maxn)
+					{
+						if (j.size() == maxn)break;
+					}
+
+					_get_next_node();
+					if (_cur_node.hold<parser_delimiter>())continue;
+					j.push_back(std::move(_cur_node));
 				}
 			}
+			_cur_node = std::move(j);
+		}
+		/**
+		 * \brief reset 后解析 s（用于复用同一个解析器解析一条条消息）
+		 * \return 解析结果，下一次 reset 前有效（也可以用 std::move(p).result() 取走）
+		 */
+		_json_t& parse(std::basic_string_view<_char_t> s)
+		{
+			reset(s);
+			parse();
+			return _cur_node;
+		}
+		_json_t& parse(_char_t* s, size_t n)
+		{
+			reset(s, n);
+			parse();
+			return _cur_node;
+		}
+
+		template<typename _iter_t>
+		parser(_iter_t beg, _iter_t end, const json_parse_error_callback_f& f= defult_parse_err_callback)
+		{
+			static_assert(!_view_mode, "in-place parsing needs a writable buffer");
+			_err_callback = f;
+			if constexpr (
+				std::contiguous_iterator<_iter_t>
+				&& std::is_same_v<std::iter_value_t<_iter_t>, _char_t>
+				) {
+				// 连续内存直接按指针解析
+				_set_input(std::to_address(beg), static_cast<size_t>(end - beg));
+			}
+			else
+			{
+				_set_input([beg, end](_char_t* buf, size_t n) mutable
+					{
+						size_t cnt = 0;
+						for (; cnt < n && beg != end; ++beg)buf[cnt++] = *beg;
+						return cnt;
+					});
+			}
+			parse();
+		}
+
+		parser(const _char_t* s, size_t n, const json_parse_error_callback_f& f = defult_parse_err_callback)
+			:parser(defer, s, n, f)
+		{
+			parse();
+		}
+		/*
+		* 从可写缓冲区解析；_json_t 的字符串类型为 string_view 时原地解析（见 _view_mode），
+		* 此时 s 中含转义的字符串会被改写
+		*/
+		parser(_char_t* s, size_t n, const json_parse_error_callback_f& f = defult_parse_err_callback)
+			:parser(defer, s, n, f)
+		{
+			parse();
+		}
+		parser(std::basic_string_view<_char_t> s, const json_parse_error_callback_f& f = defult_parse_err_callback)
+			:parser(s.data(), s.size(), f) {}
+
+		parser(std::istream& is, const json_parse_error_callback_f& f= defult_parse_err_callback)
+			:parser(defer, is, f)
+		{
+			parse(1);
+		}
+
+		parser(defer_t, const _char_t* s, size_t n, const json_parse_error_callback_f& f = defult_parse_err_callback)
+		{
+			static_assert(!_view_mode, "in-place parsing needs a writable buffer");
+			_err_callback = f;
+			_set_input(s, n);
+		}
+		parser(defer_t, _char_t* s, size_t n, const json_parse_error_callback_f& f = defult_parse_err_callback)
+		{
+			_err_callback = f;
+			_set_input(s, n);
+		}
+		parser(defer_t, std::basic_string_view<_char_t> s, const json_parse_error_callback_f& f = defult_parse_err_callback)
+			:parser(defer, s.data(), s.size(), f) {}
+		parser(defer_t, std::istream& is, const json_parse_error_callback_f& f = defult_parse_err_callback)
+		{
+			static_assert(!_view_mode, "in-place parsing needs a writable buffer");
+			_err_callback = f;
+			std::istream::sentry guard(is, true);
+			_set_input(guard ? _make_stream_reader(is) : read_f());
+			if (guard)_stream = &is;
+		}
+
+		parser(push_t, const json_parse_error_callback_f& f = defult_parse_err_callback)
+		{
+			static_assert(!_view_mode, "in-place parsing needs a writable buffer");
+			_err_callback = f;
+			_feeding = _push_mode = true;
+		}
+
+		// 构造一个没有输入的解析器，之后用 reset / parse(s) 反复解析
+		explicit parser(const json_parse_error_callback_f& f = defult_parse_err_callback)
+		{
+			_err_callback = f;
+		}
+
+		parser(const parser&) = delete;
+		parser& operator=(const parser&) = delete;
+
+		~parser()
+		{
+			if (_stream)_unread_to(*_stream);
+		}
+
+		void get_result_to(_json_t& out)const
+		{
+			out = _cur_node;
+		}
+		const _json_t& result()const&
+		{
+			return _cur_node;
+		}
+		_json_t result()&&
+		{
+			return std::move(_cur_node);
+		}
+	};
+
+	/*
+	* 线程局部的解析器池：acquire 取出一个空闲的解析器（没有则新建），
+	* 租约析构时 reset 并恢复默认设置（reset_settings）后放回，借用者的设置与其引用的对象不会留给下一个借用者。
+	* 同一线程上连续的解析因此复用解析器的各缓冲区；嵌套使用（如在错误回调中再解析）会取得不同的解析器
+	*/
+	template<typename _json_t>
+	class parser_pool
+	{
+	private:
+		using _parser_t = parser<_json_t>;
+
+		std::vector<std::unique_ptr<_parser_t>> _free;
+
+		static parser_pool& _local()
+		{
+			thread_local parser_pool pool;
+			return pool;
+		}
+
+	public:
+		class lease
+		{
+		private:
+			std::unique_ptr<_parser_t> _p;
+
+		public:
+			explicit lease(std::unique_ptr<_parser_t> p) :_p(std::move(p)) {}
+			lease(lease&&) = default;
+			lease& operator=(lease&&) = delete;
+			~lease()
+			{
+				if (!_p)return;
+				_p->reset();
+				_p->reset_settings();
+				_local()._free.push_back(std::move(_p));
+			}
+
+			_parser_t& operator*()const { return *_p; }
+			_parser_t* operator->()const { return _p.get(); }
+		};
+
+		static lease acquire()
+		{
+			auto& free = _local()._free;
+			if (free.empty())return lease(std::make_unique<_parser_t>());
+			lease res(std::move(free.back()));
+			free.pop_back();
+			return res;
+		}
+	};
+
+	json_callback_ret defult_parse_err_callback(
+		uint32_t line, uint32_t column,
+		json_error_origin origin,
+		json_parse_error e, const std::string& msg
+	)
+	{
+		std::stringstream ss;
+		ss << "parser`<json_source>:" << line << '`' << column << ':';
+		switch (origin)
+		{
+		case sjson::json_error_origin::parse_comment:
+			ss << "parse_comment";
+			break;
+		case sjson::json_error_origin::parse_string:
+			ss << "parse_string";
+			break;
+		case sjson::json_error_origin::parse_unicode:
+			ss << "parse_unicode";
+			break;
+		case sjson::json_error_origin::parse_keyword:
+			ss << "parse_keyword";
+			break;
+		case sjson::json_error_origin::parse_delimiter:
+			ss << "parse_delimiter";
+			break;
+		case sjson::json_error_origin::parse_array:
+			ss << "parse_array";
+			break;
+		case sjson::json_error_origin::parse_object:
+			ss << "parse_object";
+			break;
+		case sjson::json_error_origin::parse_number:
+			ss << "parse_number";
+			break;
+		case sjson::json_error_origin::bind_value:
+			ss << "bind_value";
+			break;
+		case sjson::json_error_origin::validate_utf8:
+			ss << "validate_utf8";
+			break;
+		default:
+			break;
+		}
+		ss << ": ";
+		switch (e)
+		{
+		case sjson::json_parse_error::item_not_closed:
+			ss << "item_not_closed";
+			break;
+		case sjson::json_parse_error::illegal_escape:
+			ss << "illegal_escape";
+
+			break;
+		case sjson::json_parse_error::invalid_unicode_code:
+			ss << "invalid_unicode_code";
+
+			break;
+		case sjson::json_parse_error::unknown_keyword:
+			ss << "unknown_keyword";
+
+			break;
+		case sjson::json_parse_error::unexpected_item:
+			ss << "unexpected_item";
+
+			break;
+		case sjson::json_parse_error::too_deep:
+			ss << "too_deep";
+			break;
+		case sjson::json_parse_error::invalid_utf8:
+			ss << "invalid_utf8";
+			break;
+		default:
+			break;
+		}
+
+		ss << ' ' << msg << '\n';
+
+		std::cout << ss.str();
+
+		return json_callback_ret::ignore_and_continue;
+	}
+
+	// 将 p 中剩余的顶层值逐个交给 func（见 sjson::for_each_value）
+	template<typename _json_t, typename _func_t>
+	size_t for_each_value_of(parser<_json_t>& p, _func_t& func)
+	{
+		size_t n = 0;
+		while (_json_t* j = p.next_value())
+		{
+			n++;
+			if constexpr (std::is_same_v<std::invoke_result_t<_func_t&, _json_t&>, bool>)
+			{
+				if (!func(*j))break;
+			}
+			else
+			{
+				func(*j);
+			}
+		}
+		return n;
+	}
+};
+
+using json = _basic_json<>;
+
+inline json operator "" _json(const char* s, size_t n)
+{
+	return _sjson_detail::parser<json>(s, s + n).result();
+}
+
+/*
+* 字符串与键以 string_view 保存的 json（由 parse_in_place 得到），引用解析时的输入缓冲区
+*/
+using json_view = _basic_json<std::string_view>;
+
+/*
+* 以 std::pmr 内存资源分配的 json：每个结点记住构造时的资源，operator[]、push_back 等新建的子结点沿用它，
+* 以 std::allocator_arg 构造来指定资源（未指定时为默认资源）。
+* 配合 monotonic_buffer_resource 可让整个文档在一块内存中分配、随资源一次释放（见 sjson::parse_pmr）
+*/
+using pmr_json = _basic_json<std::pmr::string, _sjson_detail::pmr_unordered_map, _sjson_detail::pmr_vector>;
+
+/*
+* 对象以 flat_map 保存的 json：对象按插入顺序连续保存，适合大多数对象只有少量键的文档
+*/
+using flat_json = _basic_json<std::string, flat_map>;
+
+/*
+* 对象以 swiss_map 保存的 json：适合含有很大的对象（数万到上百万个键）的文档。
+* dump 的键顺序在各次运行之间不同，除非定义了 _SJSON_HASH_SEED
+*/
+using swiss_json = _basic_json<std::string, swiss_map>;
+
+/*
+* 紧凑的 json 结点（16 字节）：数字、布尔、null 与不超过 15 字节的字符串直接保存在结点内，
+* 数组、对象与更长的字符串放在堆上，结点只持有指针。
+* 适合保存大量小值（如很长的数字数组）：_basic_json 的每个结点都与其中最大的容器一样大。
+* 对象按插入顺序保存为键值对的数组，查找为线性的（适合键不多的对象）。
+* 由 sjson::parse_compact 直接构建（不生成中间的 json 树），或用 from_json / to_json 与 json 互相转换
+*/
+class compact_json
+{
+public:
+
+	using array_t = std::vector<compact_json>;
+	using object_t = std::vector<std::pair<compact_json, compact_json>>; // 键为字符串结点
+
+	static constexpr size_t max_short_string = 15;
+
+private:
+
+	enum _kind :uint8_t
+	{
+		_kind_null, _kind_bool, _kind_i64, _kind_u64, _kind_double,
+		_kind_short_str, _kind_long_str, _kind_array, _kind_object
+	};
+
+	/*
+	* [0, 8) 为数值或指针，短字符串占用 [0, 15)
+	* _tag 的低 4 位为 _kind，短字符串时高 4 位为长度
+	*/
+	alignas(8) unsigned char _bytes[15];
+	uint8_t _tag = _kind_null;
+
+	_kind _get_kind()const { return static_cast<_kind>(_tag & 0x0f); }
+
+	template<typename _t>
+	_t _load()const
+	{
+		_t x;
+		std::memcpy(&x, _bytes, sizeof(_t));
+		return x;
+	}
+	template<typename _t>
+	void _store(_kind k, _t x)
+	{
+		std::memcpy(_bytes, &x, sizeof(_t));
+		_tag = k;
+	}
+
+	void _destroy()
+	{
+		switch (_get_kind())
+		{
+		case _kind_long_str: delete _load<std::string*>(); break;
+		case _kind_array: delete _load<array_t*>(); break;
+		case _kind_object: delete _load<object_t*>(); break;
+		default: break;
 		}
+		_tag = _kind_null;
+	}
 
-		_json_t _parse_num()
+	void _assign_string(std::string_view s)
+	{
+		if (s.size() <= max_short_string)
 		{
-			bool is_float = false;
-			_str_t buf;
+			std::memcpy(_bytes, s.data(), s.size());
+			_tag = static_cast<uint8_t>(_kind_short_str | (s.size() << 4));
+		}
+		else _store(_kind_long_str, new std::string(s));
+	}
+
+	const array_t& _array()const
+	{
+		if (_get_kind() != _kind_array)
+			_JSON_THROW(std::string("call method of compact_json::array on compact_json::") + value_t_name(), 1);
+		return *_load<array_t*>();
+	}
+	const object_t& _object()const
+	{
+		if (_get_kind() != _kind_object)
+			_JSON_THROW(std::string("call method of compact_json::object on compact_json::") + value_t_name(), 1);
+		return *_load<object_t*>();
+	}
+
+public:
+
+	compact_json() noexcept {}
+	compact_json(std::nullptr_t) noexcept {}
+	compact_json(bool b) { _store(_kind_bool, b); }
+	template<
+		typename _t,
+		std::enable_if_t<std::is_integral_v<_t> && !std::is_same_v<_t, bool> && !std::is_same_v<_t, char>, int> = 0
+	>
+	compact_json(_t x)
+	{
+		if constexpr (std::is_signed_v<_t>)_store(_kind_i64, static_cast<int64_t>(x));
+		else if (static_cast<uint64_t>(x) <= static_cast<uint64_t>(std::numeric_limits<int64_t>::max()))
+			_store(_kind_i64, static_cast<int64_t>(x));
+		else _store(_kind_u64, static_cast<uint64_t>(x));
+	}
+	compact_json(double d) { _store(_kind_double, d); }
+	compact_json(std::string_view s) { _assign_string(s); }
+	compact_json(const char* s) { _assign_string(s); }
+	compact_json(const std::string& s) { _assign_string(s); }
+	compact_json(json_value_t t)
+	{
+		switch (t)
+		{
+		case json_value_t::array: _store(_kind_array, new array_t()); break;
+		case json_value_t::object: _store(_kind_object, new object_t()); break;
+		case json_value_t::boolean: _store(_kind_bool, false); break;
+		case json_value_t::num_double: _store(_kind_double, 0.0); break;
+		case json_value_t::string: _assign_string({}); break;
+		case json_value_t::num_i32: case json_value_t::num_ui32:
+		case json_value_t::num_i64: case json_value_t::num_ui64:
+		case json_value_t::num_raw:
+			_store(_kind_i64, int64_t(0));
+			break;
+		default:
+			break;
+		}
+	}
+
+	compact_json(const compact_json& x)
+	{
+		switch (x._get_kind())
+		{
+		case _kind_long_str: _store(_kind_long_str, new std::string(*x._load<std::string*>())); break;
+		case _kind_array: _store(_kind_array, new array_t(x._array())); break;
+		case _kind_object: _store(_kind_object, new object_t(x._object())); break;
+		default:
+			std::memcpy(_bytes, x._bytes, sizeof(_bytes));
+			_tag = x._tag;
+			break;
+		}
+	}
+	// 移动只复制 16 字节，x 变为 null
+	compact_json(compact_json&& x) noexcept
+	{
+		std::memcpy(_bytes, x._bytes, sizeof(_bytes));
+		_tag = x._tag;
+		x._tag = _kind_null;
+	}
+	compact_json& operator=(compact_json x) noexcept
+	{
+		swap(x);
+		return *this;
+	}
+	~compact_json() { _destroy(); }
+
+	void swap(compact_json& x) noexcept
+	{
+		std::swap(_bytes, x._bytes);
+		std::swap(_tag, x._tag);
+	}
+
+	/**
+	 * @return 对应的 json 类型：整数为 num_i64（超出 int64_t 的为 num_ui64）
+	 */
+	json_value_t type()const
+	{
+		switch (_get_kind())
+		{
+		case _kind_bool: return json_value_t::boolean;
+		case _kind_i64: return json_value_t::num_i64;
+		case _kind_u64: return json_value_t::num_ui64;
+		case _kind_double: return json_value_t::num_double;
+		case _kind_short_str: case _kind_long_str: return json_value_t::string;
+		case _kind_array: return json_value_t::array;
+		case _kind_object: return json_value_t::object;
+		default: return json_value_t::null;
+		}
+	}
+	const char* value_t_name()const { return json_value_t_name(type()); }
 
-			if (_cur_ch == '-' || _cur_ch == '+')
+	/**
+	 * @brief 读取标量值：数字之间按 static_cast 转换，std::string_view 取得字符串（引用结点内部）
+	 * @return 类型不符时返回 _t()
+	 */
+	template<typename _t>
+	_t get()const
+	{
+		if constexpr (std::is_same_v<_t, std::string_view>)
+		{
+			switch (_get_kind())
 			{
-				buf.push_back(_cur_ch);
-				_get_nextch();
+			case _kind_short_str: return _t(reinterpret_cast<const char*>(_bytes), _tag >> 4);
+			case _kind_long_str: return *_load<std::string*>();
+			default: return _t();
 			}
-			while (true)
+		}
+		else if constexpr (std::is_same_v<_t, std::string>)return _t(get<std::string_view>());
+		else if constexpr (std::is_same_v<_t, bool>)return _get_kind() == _kind_bool && _load<bool>();
+		else
+		{
+			static_assert(std::is_arithmetic_v<_t>, "compact_json::get only reads scalars");
+			switch (_get_kind())
 			{
-				while (_isdigit(_cur_ch))
-				{
-					buf.push_back(_cur_ch);
-					_get_nextch();
-				}
-				if (_cur_ch == '.')
-				{
-					buf.push_back(_cur_ch); _get_nextch();
-					is_float = true;
-					continue;
-				}
-				else if (_cur_ch == 'e' || _cur_ch == 'E')
-				{
-					buf.push_back(_cur_ch); _get_nextch();
-					if (_cur_ch == '-' || _cur_ch == '+')
-					{
-						buf.push_back(_cur_ch); _get_nextch();
-					}
-					is_float = true;
-					continue;
-				}
-				break;
+			case _kind_i64: return static_cast<_t>(_load<int64_t>());
+			case _kind_u64: return static_cast<_t>(_load<uint64_t>());
+			case _kind_double: return static_cast<_t>(_load<double>());
+			default: return _t();
+			}
+		}
+	}
+
+	array_t& get_array() { return const_cast<array_t&>(_array()); }
+	const array_t& get_array()const { return _array(); }
+	object_t& get_object() { return const_cast<object_t&>(_object()); }
+	const object_t& get_object()const { return _object(); }
+
+	size_t size()const
+	{
+		switch (_get_kind())
+		{
+		case _kind_array: return _load<array_t*>()->size();
+		case _kind_object: return _load<object_t*>()->size();
+		default: return 0;
+		}
+	}
+
+	compact_json& operator[](size_t idx) { return get_array().at(idx); }
+	const compact_json& operator[](size_t idx)const { return get_array().at(idx); }
+
+	/**
+	 * @return 键为 key 的值，不是对象或没有该键时返回 nullptr
+	 */
+	const compact_json* find(std::string_view key)const
+	{
+		if (_get_kind() != _kind_object)return nullptr;
+		for (const auto& kv : *_load<object_t*>())
+		{
+			if (kv.first.get<std::string_view>() == key)return &kv.second;
+		}
+		return nullptr;
+	}
+	compact_json* find(std::string_view key)
+	{
+		return const_cast<compact_json*>(std::as_const(*this).find(key));
+	}
+
+	// 没有该键时在末尾添加一个 null
+	compact_json& operator[](std::string_view key)
+	{
+		if (compact_json* v = find(key))return *v;
+		return emplace(key, nullptr);
+	}
+	// 没有该键时返回一个 null 的引用
+	const compact_json& operator[](std::string_view key)const
+	{
+		static const compact_json null;
+		const compact_json* v = find(key);
+		return v ? *v : null;
+	}
+	// 模板参数使 [0] 不会被当作空指针键（同 _basic_json）
+	template<typename _t, std::enable_if_t<std::is_same_v<_t, char>, int> = 0>
+	compact_json& operator[](const _t* key) { return operator[](std::string_view(key)); }
+	template<typename _t, std::enable_if_t<std::is_same_v<_t, char>, int> = 0>
+	const compact_json& operator[](const _t* key)const { return operator[](std::string_view(key)); }
+
+	void push_back(compact_json x)
+	{
+		get_array().push_back(std::move(x));
+	}
+	/**
+	 * @brief 在对象末尾添加键值对（不检查键是否已存在）
+	 * @return 添加的值
+	 */
+	compact_json& emplace(std::string_view key, compact_json x)
+	{
+		auto& obj = get_object();
+		obj.emplace_back(compact_json(key), std::move(x));
+		return obj.back().second;
+	}
+
+	/**
+	 * @brief 不带缩进地输出（格式与 json::dump(0) 相同，对象的键保持插入顺序）
+	 */
+	void dump_to(std::string& out, bool ensure_ascii = true)const
+	{
+		auto dump_string = [&out, ensure_ascii](std::string_view s)
+			{
+				out += '"';
+				if (!ensure_ascii)out += s;
+				else _sjson_detail::escape_to_ascii(s, out);
+				out += '"';
+			};
+		switch (_get_kind())
+		{
+		case _kind_null: out += "null"; break;
+		case _kind_bool: out += _load<bool>() ? "true" : "false"; break;
+		case _kind_i64: out += std::to_string(_load<int64_t>()); break;
+		case _kind_u64: out += std::to_string(_load<uint64_t>()); break;
+		case _kind_double: _sjson_detail::dump_double_to(_load<double>(), out); break;
+		case _kind_short_str: case _kind_long_str: dump_string(get<std::string_view>()); break;
+		case _kind_array:
+		{
+			out += '[';
+			bool first = true;
+			for (const auto& x : *_load<array_t*>())
+			{
+				if (!first)out += ',';
+				first = false;
+				x.dump_to(out, ensure_ascii);
+			}
+			out += ']';
+			break;
+		}
+		case _kind_object:
+		{
+			out += '{';
+			bool first = true;
+			for (const auto& kv : *_load<object_t*>())
+			{
+				if (!first)out += ',';
+				first = false;
+				dump_string(kv.first.get<std::string_view>());
+				out += ':';
+				kv.second.dump_to(out, ensure_ascii);
+			}
+			out += '}';
+			break;
+		}
+		}
+	}
+	std::string dump(bool ensure_ascii = true)const
+	{
+		std::string res;
+		dump_to(res, ensure_ascii);
+		return res;
+	}
+
+	/**
+	 * @brief 转换为 _json_t（能放入 int32_t 的整数转换为 num_i32，与解析时相同）
+	 */
+	template<typename _json_t = json>
+	_json_t to_json()const
+	{
+		using array_t_ = typename _json_t::array_t;
+		using object_t_ = typename _json_t::object_t;
+		using string_t_ = typename _json_t::string_t;
+		switch (_get_kind())
+		{
+		case _kind_bool: return _load<bool>();
+		case _kind_i64:
+		{
+			int64_t v = _load<int64_t>();
+			if ((std::numeric_limits<int32_t>::min)() <= v && v <= std::numeric_limits<int32_t>::max())
+				return static_cast<int32_t>(v);
+			return v;
+		}
+		case _kind_u64: return _load<uint64_t>();
+		case _kind_double: return _load<double>();
+		case _kind_short_str: case _kind_long_str:
+		{
+			auto s = get<std::string_view>();
+			return string_t_(s.begin(), s.end());
+		}
+		case _kind_array:
+		{
+			array_t_ arr;
+			arr.reserve(size());
+			for (const auto& x : *_load<array_t*>())arr.push_back(x.to_json<_json_t>());
+			return arr;
+		}
+		case _kind_object:
+		{
+			object_t_ obj;
+			for (const auto& kv : *_load<object_t*>())
+			{
+				auto k = kv.first.get<std::string_view>();
+				obj[string_t_(k.begin(), k.end())] = kv.second.to_json<_json_t>();
+			}
+			return obj;
+		}
+		default: return nullptr;
+		}
+	}
+
+	/**
+	 * @brief 从 _json_t 转换（原样保存的数字在这里转换）
+	 */
+	template<typename _json_t>
+	static compact_json from_json(const _json_t& j)
+	{
+		switch (j.type())
+		{
+		case json_value_t::array:
+		{
+			compact_json res(json_value_t::array);
+			auto& arr = res.get_array();
+			const auto& src = j.get<typename _json_t::array_t>();
+			arr.reserve(src.size());
+			for (const auto& x : src)arr.push_back(from_json(x));
+			return res;
+		}
+		case json_value_t::object:
+		{
+			compact_json res(json_value_t::object);
+			auto& obj = res.get_object();
+			const auto& src = j.get<typename _json_t::object_t>();
+			obj.reserve(src.size());
+			for (const auto& kv : src)obj.emplace_back(compact_json(std::string_view(kv.first)), from_json(kv.second));
+			return res;
+		}
+		case json_value_t::boolean: return j.get<bool>();
+		case json_value_t::num_i32: return j.get<int32_t>();
+		case json_value_t::num_ui32: return j.get<uint32_t>();
+		case json_value_t::num_i64: return j.get<int64_t>();
+		case json_value_t::num_ui64: return j.get<uint64_t>();
+		case json_value_t::num_double: return j.get<double>();
+		case json_value_t::num_raw:
+		{
+			const auto& r = j.get<typename _json_t::raw_number_t>();
+			if (r.integral)
+			{
+				int64_t i;
+				if (_sjson_detail::raw_number_get(r, i))return i;
+				uint64_t u;
+				if (!r.fits_int64 && _sjson_detail::raw_number_get(r, u))return u;
 			}
+			return _sjson_detail::raw_number_cast<double>(r);
+		}
+		case json_value_t::string: return std::string_view(j.get<typename _json_t::string_t>());
+		default: return nullptr;
+		}
+	}
+};
+static_assert(sizeof(compact_json) == 16, "compact_json should stay a 16-byte node");
 
-			if (is_float)
+namespace _sjson_detail
+{
+	// 以 SAX 事件直接构建 compact_json（见 sjson::parse_compact），只取第一个顶层值
+	struct compact_builder
+	{
+		compact_json root;
+		std::vector<compact_json*> stack; // 尚未闭合的容器，它们总是父容器的最后一个元素，地址不会失效
+		compact_json pending_key;
+
+		compact_json* add(compact_json&& x)
+		{
+			if (stack.empty())
 			{
-				return _json_t(std::stod(buf));
+				root = std::move(x);
+				return &root;
 			}
-			else
+			compact_json& top = *stack.back();
+			if (top.type() == json_value_t::array)
 			{
-				long long n = std::stoll(buf);
-				return (n <= std::numeric_limits<int>::max())
-					? _json_t(static_cast<int>(n))
-					: _json_t(n);
-
+				auto& arr = top.get_array();
+				arr.push_back(std::move(x));
+				return &arr.back();
 			}
+			auto& obj = top.get_object();
+			obj.emplace_back(std::move(pending_key), std::move(x));
+			return &obj.back().second;
 		}
-
-		void _parse_unicode_to(_str_t& s)
+		bool value(compact_json&& x)
 		{
-			uint32_t idx = 0, val = 0;
-			uint8_t digit = 0;
+			add(std::move(x));
+			return !stack.empty();
+		}
 
-			_str_t buf = "\\u";
+		bool start_object() { stack.push_back(add(json_value_t::object)); return true; }
+		bool start_array() { stack.push_back(add(json_value_t::array)); return true; }
+		bool end_object() { stack.pop_back(); return !stack.empty(); }
+		bool end_array() { stack.pop_back(); return !stack.empty(); }
+		bool key(std::string_view k) { pending_key = compact_json(k); return true; }
+		bool string(std::string_view s) { return value(s); }
+		bool number_int64(int64_t x) { return value(x); }
+		bool number_uint64(uint64_t x) { return value(x); }
+		bool number_double(double x) { return value(x); }
+		bool boolean(bool x) { return value(x); }
+		bool null() { return value(nullptr); }
+	};
+}
 
-			while (idx++ < 4)
-			{
-				_get_nextch();
-				_cur_node_start_pos = _cur_pos;
-				buf.push_back(_cur_ch);
-				if (_is_end())
-				{
-					// 错误 字符串未闭合
-					_throw_err(_origin::parse_string, _error::item_not_closed);
-					break;
-				}
-				else if ('0' <= _cur_ch && _cur_ch <= '9')
-				{
-					digit = _cur_ch - '0';
-				}
-				else if ('a' <= _cur_ch && _cur_ch <= 'f')
-				{
-					digit = _cur_ch - 'a' + 10;
-				}
-				else if ('A' <= _cur_ch && _cur_ch <= 'F')
-				{
-					digit = _cur_ch - 'A' + 10;
-				}
-				else
-				{
-					// 错误 非法的 unicode 转义
-					_throw_err(_origin::parse_unicode, _error::illegal_escape, buf);
-					break;
-				}
-				val = val * 16 | digit;
-			}
+/**
+ * @brief 原地解析 s：不含转义的字符串与键直接引用 s，含转义的在 s 中原地解码，不为字符串分配内存
+ * @param s 可写的输入，其中含转义的字符串会被改写；结果存续期间 s 必须有效且不能移动
+ * @param n s 的长度
+ */
+template<typename _json_t = json_view>
+_json_t parse_in_place(
+	typename _json_t::string_char_t* s, size_t n,
+	const json_parse_error_callback_f& f = _sjson_detail::defult_parse_err_callback
+)
+{
+	return _sjson_detail::parser<_json_t>(s, n, f).result();
+}
+/**
+ * @brief 原地解析 s（见上），结果存续期间不能修改 s
+ */
+template<typename _json_t = json_view>
+_json_t parse_in_place(
+	std::basic_string<typename _json_t::string_char_t>& s,
+	const json_parse_error_callback_f& f = _sjson_detail::defult_parse_err_callback
+)
+{
+	return parse_in_place<_json_t>(s.data(), s.size(), f);
+}
+/**
+ * @brief 原地解析 s，并将长度不超过 max_len 的字符串与键放入 pool（见 _sjson_detail::parser::set_string_pool）
+ */
+template<typename _json_t = json_view>
+_json_t parse_in_place(
+	std::basic_string<typename _json_t::string_char_t>& s,
+	basic_string_pool<typename _json_t::string_char_t>& pool, size_t max_len = 32,
+	const json_parse_error_callback_f& f = _sjson_detail::defult_parse_err_callback
+)
+{
+	using _parser_t = _sjson_detail::parser<_json_t>;
+	_parser_t p(_parser_t::defer, s.data(), s.size(), f);
+	p.set_string_pool(&pool, max_len);
+	p.parse();
+	return std::move(p).result();
+}
 
-			auto need = _sjson_detail::utf8::get_byte_num_of_encode(val);
+/**
+ * @brief 逐个读取 s 中的顶层值（NDJSON 或以空白分隔的多个 json），每读完一个就交给 func 处理，
+ *        不会把全部值收集到一个数组中
+ * @param func 以 _json_t& 为参数，返回 bool 时返回 false 表示停止读取
+ * @return 读到的值的个数
+ */
+template<typename _json_t = json, typename _func_t>
+size_t for_each_value(
+	std::basic_string_view<typename _json_t::string_char_t> s, _func_t&& func,
+	const json_parse_error_callback_f& f = _sjson_detail::defult_parse_err_callback
+)
+{
+	_sjson_detail::parser<_json_t> p(_sjson_detail::parser<_json_t>::defer, s, f);
+	return _sjson_detail::for_each_value_of(p, func);
+}
+/**
+ * @brief 逐个读取流中的顶层值（NDJSON 或以空白分隔的多个 json），每读完一个就交给 func 处理，
+ *        内存占用只与单个值的大小有关
+ * @param func 以 _json_t& 为参数，返回 bool 时返回 false 表示停止读取（未读取的部分留在流中）
+ * @return 读到的值的个数
+ */
+template<typename _json_t = json, typename _func_t>
+size_t for_each_value(
+	std::istream& is, _func_t&& func,
+	const json_parse_error_callback_f& f = _sjson_detail::defult_parse_err_callback
+)
+{
+	_sjson_detail::parser<_json_t> p(_sjson_detail::parser<_json_t>::defer, is, f);
+	return _sjson_detail::for_each_value_of(p, func);
+}
 
-			if (need == 0)
-			{
-				// 错误 无效的 unicode
-				_throw_err(_origin::parse_unicode, _error::invalid_unicode_code, buf);
-				return;
-			}
+/**
+ * @brief 用当前线程的解析器池（见 _sjson_detail::parser_pool）中的解析器解析 s，
+ *        适合大量小消息：各次解析复用同一解析器的缓冲区，省去每次构造解析器的开销
+ */
+template<typename _json_t = json>
+_json_t parse_pooled(
+	std::basic_string_view<typename _json_t::string_char_t> s,
+	const json_parse_error_callback_f& f = _sjson_detail::defult_parse_err_callback
+)
+{
+	auto p = _sjson_detail::parser_pool<_json_t>::acquire();
+	p->set_error_callback(f);
+	p->parse(s);
+	return std::move(*p).result();
+}
 
-			s.resize(s.size() + need);
+/**
+ * @brief 解析 s，结果中的字符串与容器都从 res 分配（res 需比结果活得更久）
+ */
+template<typename _json_t = pmr_json>
+_json_t parse_pmr(
+	std::basic_string_view<typename _json_t::string_char_t> s, std::pmr::memory_resource* res,
+	const json_parse_error_callback_f& f = _sjson_detail::defult_parse_err_callback
+)
+{
+	_sjson_detail::parser<_json_t> p(_sjson_detail::parser<_json_t>::defer, s, f);
+	p.set_memory_resource(res);
+	p.parse();
+	return std::move(p).result();
+}
 
-			_sjson_detail::utf8::encode((uint8_t*)s.data() + s.size() - need, val);
-		}
+/**
+ * @brief 多线程解析根为数组的单个大 json（见 _sjson_detail::parser::parse_parallel）
+ * @param threads 线程数，为 0 时使用硬件线程数
+ */
+template<typename _json_t = json>
+_json_t parse_parallel(
+	std::basic_string_view<typename _json_t::string_char_t> s, size_t threads = 0,
+	const json_parse_error_callback_f& f = _sjson_detail::defult_parse_err_callback
+)
+{
+	return _sjson_detail::parser<_json_t>::parse_parallel(s.data(), s.size(), threads, f);
+}
 
-		_json_t _parse_string()
-		{
-			_str_t buf;
-			while (true)
-			{
-				_cur_node_start_pos = _cur_pos;
-				if (_is_end())
-				{
-					// 错误 字符串未闭合
-					_throw_err(_origin::parse_string, _error::item_not_closed);
-					break;
-				}
-				else if (_cur_ch == '"')
-				{
-					_get_nextch();
-					break;
-				}
-				else if (_cur_ch == '\\')
-				{
-					_get_nextch();
-					char ch = 0;
-					switch (_cur_ch)
-					{
-					case '0':break;
-					case 'a':ch = '\a'; break;
-					case 'b':ch = '\b'; break;
-					case 'f':ch = '\f'; break;
-					case 'n':ch = '\n'; break;
-					case 'r':ch = '\r'; break;
-					case 't':ch = '\t'; break;
-					case '"':ch = '\"'; break;
-					case '\\':ch = '\\'; break;
-					case 'u':
-					{
-						// _get_nextch() 在 _parse_unicode_to 处进行
-						_parse_unicode_to(buf);
-						_get_nextch();
-						continue;
-						break;
-					}
-					default:
-						ch = _cur_ch;
-						_throw_err(
-							_origin::parse_string, _error::illegal_escape,
-							{ '\\',ch }
-						);
-						break;
-					}
-					buf.push_back(ch);
-				}
-				else
-				{
-					buf.push_back(_cur_ch);
-				}
-				_get_nextch();
-			}
-			return buf;
-		}
+/**
+ * @brief 以事件（SAX）方式解析 s 中的全部值，不构建 json 树
+ * @param h 事件处理器（要求见 _sjson_detail::parser::parse_sax）
+ * @return 是否解析到了输入结尾
+ */
+template<typename _json_t = json, typename _handler_t>
+bool sax_parse(
+	std::basic_string_view<typename _json_t::string_char_t> s, _handler_t& h,
+	const json_parse_error_callback_f& f = _sjson_detail::defult_parse_err_callback
+)
+{
+	_sjson_detail::parser<_json_t> p(_sjson_detail::parser<_json_t>::defer, s, f);
+	return p.parse_sax(h);
+}
+/**
+ * @brief 以事件（SAX）方式解析流中的全部值，不构建 json 树
+ * @param h 事件处理器（要求见 _sjson_detail::parser::parse_sax）
+ * @return 是否解析到了输入结尾
+ */
+template<typename _json_t = json, typename _handler_t>
+bool sax_parse(
+	std::istream& is, _handler_t& h,
+	const json_parse_error_callback_f& f = _sjson_detail::defult_parse_err_callback
+)
+{
+	_sjson_detail::parser<_json_t> p(_sjson_detail::parser<_json_t>::defer, is, f);
+	return p.parse_sax(h);
+}
 
-		_json_t _parse_keyword()
-		{
-			_cur_node_start_pos = _cur_pos;
-			_str_t buf;
-			buf.push_back(_cur_ch);
-			_get_nextch();
-			while (_isalnum(_cur_ch) || _cur_ch == '_')
-			{
-				buf.push_back(_cur_ch);
-				_get_nextch();
-			}
+/**
+ * @brief 将 s 中的第一个值解析为 compact_json（由 SAX 事件直接构建，不生成中间的 json 树）
+ */
+inline compact_json parse_compact(
+	std::string_view s,
+	const json_parse_error_callback_f& f = _sjson_detail::defult_parse_err_callback
+)
+{
+	_sjson_detail::compact_builder b;
+	sax_parse<json>(s, b, f);
+	return std::move(b.root);
+}
 
-			if (buf == "true")return true;
-			else if (buf == "false")return false;
-			else if (buf == "null")return nullptr;
+/**
+ * @brief 校验 s 是否为合法的 UTF-8（拒绝截断的序列、过长编码、代理项与超出 U+10FFFF 的码点）
+ * @return 第一个不合法序列的字节偏移，全部合法返回 std::string_view::npos
+ */
+inline size_t validate_utf8(std::string_view s)
+{
+	const char* end = s.data() + s.size();
+	const char* bad = _sjson_detail::simd::validate_utf8(s.data(), end);
+	return bad == end ? std::string_view::npos : static_cast<size_t>(bad - s.data());
+}
 
-			// 错误 未知的关键词 
-			_throw_err(_origin::parse_keyword, _error::unknown_keyword, buf);
+/**
+ * @brief 映射并解析整个文件，解析完成后即解除映射（比先读入字符串或从流解析少一次复制）
+ * @param path 文件路径
+ */
+template<typename _json_t = json>
+_json_t parse_file(
+	const std::string& path,
+	const json_parse_error_callback_f& f = _sjson_detail::defult_parse_err_callback
+)
+{
+	const mapped_file m(path);
+	_sjson_detail::parser<_json_t> p(m.data(), m.size(), f);
+	return std::move(p).result();
+}
+/**
+ * @brief 原地解析映射的文件（见 parse_in_place），结果引用映射，存续期间 m 不能关闭或销毁
+ * @param m 以 copy_on_write 打开的映射（改写只影响本进程，不会写回文件）
+ */
+template<typename _json_t = json_view>
+_json_t parse_in_place(
+	mapped_file& m,
+	const json_parse_error_callback_f& f = _sjson_detail::defult_parse_err_callback
+)
+{
+	if (!m.writable())_JSON_THROW("in-place parsing needs a copy_on_write mapping", 0);
+	return parse_in_place<_json_t>(m.data(), m.size(), f);
+}
 
-			return nullptr;
-		}
+/**
+ * @brief 投影解析 s 中的第一个值：只解析 pointers 所指的部分（见 _sjson_detail::parser::parse_projection）
+ * @param pointers 指针字符串（也可以是能转换为 std::string 的类型，如 hpjson::json_pointer）
+ */
+template<typename _json_t = json, typename _ptr_t>
+_json_t parse_projection(
+	std::basic_string_view<typename _json_t::string_char_t> s, const std::vector<_ptr_t>& pointers,
+	const json_parse_error_callback_f& f = _sjson_detail::defult_parse_err_callback
+)
+{
+	_sjson_detail::parser<_json_t> p(_sjson_detail::parser<_json_t>::defer, s, f);
+	return p.parse_projection(pointers);
+}
+/**
+ * @brief 投影解析流中的下一个值（见 _sjson_detail::parser::parse_projection）
+ */
+template<typename _json_t = json, typename _ptr_t>
+_json_t parse_projection(
+	std::istream& is, const std::vector<_ptr_t>& pointers,
+	const json_parse_error_callback_f& f = _sjson_detail::defult_parse_err_callback
+)
+{
+	_sjson_detail::parser<_json_t> p(_sjson_detail::parser<_json_t>::defer, is, f);
+	return p.parse_projection(pointers);
+}
 
-		_json_t _parse_simple_node()
-		{
-			if(_is_end()) return parser_delimiter(end_flag);
-			while (!_is_end())
-			{
-				_skip_space();
-				if (_is_end())return parser_delimiter(end_flag);
-				switch (_cur_ch)
-				{
-				case '/':
-					if (_look_nextch() == '/' || _look_nextch() == '*')
-					{
-						_skip_comment();
-						continue;
-					}
-					else
-					{
-						// 错误 意外的标识符
-						_throw_err(
-							_origin::parse_comment,
-							_error::unexpected_item,
-							{ '{','[','/','\\','*',']','}','@',_look_nextch(),'\0' }
-						);
-					}
-					break;
-				case '"':
-				{
-					_get_nextch();
-					return  _parse_string();
-					break;
-				}
-				case ',': case ':': case '[': case ']':	case '{': case '}':
-				{
-					_char_t tmp = _cur_ch;
-					_get_nextch();
-					return static_cast<parser_delimiter>(tmp);
-				}
-				default:
+/**
+ * @brief 把 s 中的第一个值直接读入 out，不构建 json 树（类型要求见 SJSON_BIND）
+ * @return 是否读完了整个值
+ */
+template<typename _t, typename _json_t = json>
+bool parse_into(
+	std::string_view s, _t& out,
+	const json_parse_error_callback_f& f = _sjson_detail::defult_parse_err_callback
+)
+{
+	_sjson_detail::parser<_json_t> p(_sjson_detail::parser<_json_t>::defer, s, f);
+	return p.read_to(out);
+}
+/**
+ * @brief 从流中读取一个值直接存入 out，不构建 json 树（类型要求见 SJSON_BIND）
+ * @return 是否读完了整个值
+ */
+template<typename _t, typename _json_t = json>
+bool parse_into(
+	std::istream& is, _t& out,
+	const json_parse_error_callback_f& f = _sjson_detail::defult_parse_err_callback
+)
+{
+	_sjson_detail::parser<_json_t> p(_sjson_detail::parser<_json_t>::defer, is, f);
+	return p.read_to(out);
+}
 
-					if (_isdigit(_cur_ch) || _cur_ch == '-' || _cur_ch == '+')
-					{
-						return _parse_num();
-					}
-					else if (_isalpha(_cur_ch))
-					{
-						return _parse_keyword();
-					}
-					_throw_err(
-						_origin::parse_delimiter,
-						_error::unexpected_item,
-						std::string("{[/\",:\\[\\]\\{\\}}@") + _cur_ch
-					);
-					_get_nextch();
-					return static_cast<parser_delimiter>(_cur_ch);
-					break;
-				}
-				break;
-			}
-			return nullptr;
-		}
+/**
+ * @brief 原地解析 s 并直接读入 out（见 parse_in_place）：std::string_view 成员引用 s，
+ *        out 使用期间 s 必须有效且不能修改
+ * @return 是否读完了整个值
+ */
+template<typename _t, typename _json_t = json_view>
+bool parse_into_in_place(
+	std::string& s, _t& out,
+	const json_parse_error_callback_f& f = _sjson_detail::defult_parse_err_callback
+)
+{
+	_sjson_detail::parser<_json_t> p(_sjson_detail::parser<_json_t>::defer, s.data(), s.size(), f);
+	return p.read_to(out);
+}
 
-		void _get_next_simple_node()
-		{
-			_skip_space();
-			_cur_node_start_pos = _cur_pos;
-			_cur_node = _parse_simple_node();
-		}
+/**
+ * @brief 把 x 直接写成紧凑格式的 json（字符串转换为 ASCII），不构建 json 树（类型要求见 SJSON_BIND）
+ */
+template<typename _t>
+void dump_bound_to(const _t& x, std::string& out)
+{
+	_sjson_detail::dump_bound_to(x, out);
+}
+template<typename _t>
+std::string dump_bound(const _t& x)
+{
+	std::string res;
+	_sjson_detail::dump_bound_to(x, res);
+	return res;
+}
 
-		_json_t _parse_node()
-		{
-			_json_t j = _parse_simple_node();
-			auto delimiter = j.get_if<parser_delimiter>();
-			if (delimiter)
-			{
-				if (*delimiter == parser_delimiter::left_bracket)
-				{
-					return _parse_array();
-				}
-				else if (*delimiter == parser_delimiter::left_brace)
-				{
-					return _parse_object();
-				}
+/*
+* 按需解析的文档：只保存原始输入与结构索引（各 token 的起始位置与括号的匹配关系），
+* 通过 operator[]、at、at_pointer 查找时只在索引上跳转，
+* 只有调用 get/to_json/type 时才解析所访问的那一个值
+* 不检查未访问部分的语法；输入不能超过 4GB
+*/
+template<typename _json_t = json>
+class _basic_lazy_document
+{
+	static_assert(std::is_same_v<typename _json_t::string_char_t, char>, "lazy document only supports char input");
 
-			}
-			return j;
-		}
+	using _parser_t = _sjson_detail::parser<_json_t>;
+	using _str_t = typename _json_t::string_t;
+	static constexpr uint32_t _npos = static_cast<uint32_t>(-1);
 
-		void _get_next_node()
-		{
-			_skip_space();
-			// _cur_node_start_pos 在 _get_next_simple_node 处更新
-			_cur_node = _parse_node();
-		}
+public:
 
+	/*
+	* 文档中的一个值（或不存在的值）
+	* 只是文档与 token 序号的组合，文档被移动或销毁后失效
+	*/
+	class node
+	{
+	public:
 
-		_json_t _parse_array()
+		// 依次指向数组的元素或对象的成员的值
+		class iterator
 		{
-			_json_t res(json_value_t::array);
-			_get_next_node();
+		public:
+
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = node;
+			using difference_type = std::ptrdiff_t;
+			using pointer = void;
+			using reference = node;
+
+			iterator() = default;
 
-			while (_cur_node != parser_delimiter::right_bracket && !_is_end())
+			node operator*()const { return { _doc, _is_obj ? _idx + 1 : _idx }; }
+			// 对象成员的键（数组元素为不存在的值）
+			node key()const { return _is_obj ? node(_doc, _idx) : node(); }
+
+			iterator& operator++()
 			{
-				if (_cur_node.hold<parser_delimiter>())
-				{
-					// 错误 期望值
-					_throw_err(
-						_origin::parse_array,
-						_error::unexpected_item,
-						"<!delimiter>@" + _cur_node.dump()
-					);
-					_cur_node = nullptr;
-				}
-				res.push_back(_cur_node);
-				_get_next_simple_node();
-				if (_cur_node == parser_delimiter::right_bracket)break;
-				if (_cur_node != parser_delimiter::comma)
-				{
-					// 错误 期望 ','
-					_throw_err(
-						_origin::parse_array,
-						_error::unexpected_item,
-						"{,}@" + _cur_node.dump()
-					);
-					break;
-				}
-				_get_next_node();
+				_idx = _doc->_after(_is_obj ? _idx + 1 : _idx);
+				return *this;
 			}
-			if (_cur_node != parser_delimiter::right_bracket)
+			iterator operator++(int)
 			{
-				_throw_err(_origin::parse_array, _error::item_not_closed);
+				iterator res = *this;
+				++*this;
+				return res;
 			}
-			return res;
-		}
 
-		_json_t _parse_object()
-		{
-			_json_t res(json_value_t::object);
-			_get_next_simple_node();
+			bool operator==(const iterator& x)const
+			{
+				return _done() == x._done() && (_done() || _idx == x._idx);
+			}
+			bool operator!=(const iterator& x)const { return !(*this == x); }
 
-			_str_t key;
+		private:
 
-			while (_cur_node != parser_delimiter::right_brace && !_is_end())
-			{
-				if (!_cur_node.hold<_str_t>())
-				{
-					// 错误 期望 <string>
-					_throw_err(
-						_origin::parse_object,
-						_error::unexpected_item,
-						"<string>@" + _cur_node.dump()
-					);
-					_get_next_simple_node();
-					continue;
-				}
-				key = _cur_node.get<_str_t>();
-				_get_next_simple_node();
-				if (_cur_node != parser_delimiter::colon)
-				{
-					// 错误 期望 ':'
-					_throw_err(
-						_origin::parse_object,
-						_error::unexpected_item,
-						"{:}@" + _cur_node.dump()
-					);
-				}
-				_get_next_node();
-				if (_cur_node.hold<parser_delimiter>())
-				{
-					// 错误 期望值
-					_throw_err(
-						_origin::parse_object,
-						_error::unexpected_item,
-						"<!delimiter>@" + _cur_node.dump()
-					);
-					_cur_node = nullptr;
-				}
-				res[key] = _cur_node;
-				_get_next_simple_node();
-				if (_cur_node == parser_delimiter::right_brace)break;
-				if (_cur_node != parser_delimiter::comma)
-				{
-					// 错误 期望 ','
-					_throw_err(
-						_origin::parse_object,
-						_error::unexpected_item,
-						"{,}@" + _cur_node.dump()
-					);
-				}
-				_get_next_simple_node();
+			friend class node;
 
-			}
+			iterator(const _basic_lazy_document* doc, uint32_t idx, bool is_obj)
+				:_doc(doc), _idx(idx), _is_obj(is_obj) {}
+
+			const _basic_lazy_document* _doc = nullptr;
+			uint32_t _idx = _npos;
+			bool _is_obj = false;
 
-			if (_cur_node != parser_delimiter::right_brace)
+			bool _done()const
 			{
-				_throw_err(_origin::parse_object, _error::item_not_closed);
+				return !_doc || !_doc->_in_container(_idx)
+					|| (_is_obj && (_doc->_ch(_idx) != '"' || _idx + 1 >= _doc->_tokens.size()));
 			}
+		};
 
-			return res;
+		node() = default;
+
+		// 是否指向文档中实际存在的值
+		bool exists()const { return _doc && _idx != _npos; }
+
+		/**
+		 * @return 值的类型，对数字会解析该值以得到具体类型，不存在的值为 null
+		 */
+		json_value_t type()const
+		{
+			if (!exists())return json_value_t::null;
+			switch (_doc->_ch(_idx))
+			{
+			case '[': return json_value_t::array;
+			case '{': return json_value_t::object;
+			case '"': return json_value_t::string;
+			default: return _doc->_decode(_idx).type();
+			}
 		}
 
+		/**
+		 * @return 数组的元素个数或对象的成员个数（包括重复的键），其他值为 0
+		 */
+		size_t size()const
+		{
+			return static_cast<size_t>(std::distance(begin(), end()));
+		}
 
+		// 遍历数组的元素或对象的成员的值（不是容器时为空）
+		iterator begin()const
+		{
+			if (!exists())return {};
+			char ch = _doc->_ch(_idx);
+			if (ch != '[' && ch != '{')return {};
+			return { _doc, _idx + 1, ch == '{' };
+		}
+		iterator end()const { return {}; }
 
-	public:
+		// 对象中键为 key 的值，没有时返回不存在的值
+		node operator[](std::string_view key)const { return { _doc, exists() ? _doc->_find_key(_idx, key) : _npos }; }
+		// 数组中的第 idx 个元素，没有时返回不存在的值
+		node operator[](size_t idx)const { return { _doc, exists() ? _doc->_find_idx(_idx, idx) : _npos }; }
+		// 不使用 const char* 以防 0 被错误识别
+		template <typename _t>
+		node operator[](const _t* const key)const { return operator[](std::string_view(key)); }
 
-		void parse(size_t maxn = 0)
+		// 同 operator[]，但值不存在时抛出 json_error
+		node at(std::string_view key)const
 		{
-			_json_t j;
-			_get_next_node();
+			node res = operator[](key);
+			if (!res.exists())_JSON_THROW("key not found: " + std::string(key), 0);
+			return res;
+		}
+		node at(size_t idx)const
+		{
+			node res = operator[](idx);
+			if (!res.exists())_JSON_THROW("index out of range: " + std::to_string(idx), 0);
+			return res;
+		}
 
-			if (maxn != 1) // 如果只读一个就不跳过空白（从 cin 读入完一个后不会继续等待）
-				_skip_space(); // 防止结束后有空白导致 _is_end() 返回 false
-			if (_is_end() || maxn == 1)
-			{
-				j.assign(_cur_node);
-			}
-			else
+		/**
+		 * @brief 按 JSON Pointer（RFC 6901，如 "/a/0/b"）查找
+		 * @param ptr 指针字符串（也可以是能转换为 std::string 的类型，如 hpjson::json_pointer）
+		 * @return 找到的值，没有时返回不存在的值
+		 */
+		node at_pointer(const std::string& ptr)const
+		{
+			std::vector<std::string> toks;
+			if (!_parser_t::_split_pointer(ptr, toks))return {};
+			node res = *this;
+			for (const auto& tok : toks)
 			{
-				j.assign(json_value_t::array);
-				j.push_back(_cur_node);
-
-				while (!_is_end())
+				if (!res.exists())break;
+				if (_doc->_ch(res._idx) == '[')
 				{
-					if (maxn)
-					{
-						if (j.size() == maxn)break;
-					}
-
-					_get_next_node();
-					if (_cur_node.hold<parser_delimiter>())continue;
-					j.push_back(_cur_node);
+					bool is_idx = !tok.empty() && tok.size() < 20 && std::all_of(tok.begin(), tok.end(), [](char ch) { return '0' <= ch && ch <= '9'; });
+					res = is_idx ? res[static_cast<size_t>(std::stoull(tok))] : node();
+				}
+				else
+				{
+					res = res[std::string_view(tok)];
 				}
 			}
-			_cur_node = j;
+			return res;
 		}
 
-		template<typename _iter_t>
-		parser(_iter_t beg, _iter_t end, const json_parse_error_callback_f& f= defult_parse_err_callback)
+		/**
+		 * @brief 解析该值（及其全部子结点）
+		 * @return 解析结果，不存在的值为 null
+		 */
+		_json_t to_json()const
 		{
-			_err_callback = f;
-			_getch_func = [&beg, end]()
-			{
-				if (beg == end)return end_flag;
-				_iter_t tmp = beg;
-				++beg;
-				return *tmp;
-			};
-			_next_ch = _getch_func();
-			_get_nextch();
-			parse();
+			return exists() ? _doc->_decode(_idx) : _json_t();
 		}
 
-		parser(std::istream& is, const json_parse_error_callback_f& f= defult_parse_err_callback)
+		/**
+		 * @brief 解析该值并以 _t 类型取得（规则同 _basic_json::get<_t>() const）
+		 */
+		template<typename _t>
+		_t get()const
 		{
-			_err_callback = f;
-			_getch_func = [&is]() {return _char_t(is.get()); };
-			_next_ch = _getch_func();
-			_get_nextch();
-			parse(1);
+			const _json_t j = to_json();
+			return j.get<_t>();
 		}
 
-		void get_result_to(_json_t& out)const
-		{
-			out = _cur_node;
-		}
-		const _json_t& result()const
+		// 值在输入中的原始文本（不包括前后的空白）
+		std::string_view raw()const
 		{
-			return _cur_node;
+			if (!exists())return {};
+			return _doc->_src.substr(_doc->_tokens[_idx], _doc->_raw_end(_idx) - _doc->_tokens[_idx]);
 		}
+
+	private:
+
+		friend class _basic_lazy_document;
+
+		node(const _basic_lazy_document* doc, uint32_t idx) :_doc(doc), _idx(idx) {}
+
+		const _basic_lazy_document* _doc = nullptr;
+		uint32_t _idx = _npos;
 	};
 
-	json_callback_ret defult_parse_err_callback(
-		uint32_t line, uint32_t column,
-		json_error_origin origin,
-		json_parse_error e, const std::string& msg
-	)
+	/**
+	 * @param s 输入（文档不复制输入，使用期间需保证其有效）
+	 * @param f 解析值时使用的错误回调
+	 */
+	explicit _basic_lazy_document(
+		std::string_view s,
+		const json_parse_error_callback_f& f = _sjson_detail::defult_parse_err_callback
+	) :_src(s), _err_callback(f)
 	{
-		std::stringstream ss;
-		ss << "parser`<json_source>:" << line << '`' << column << ':';
-		switch (origin)
+		_build();
+	}
+	// 文档保存输入的副本
+	explicit _basic_lazy_document(
+		std::string&& s,
+		const json_parse_error_callback_f& f = _sjson_detail::defult_parse_err_callback
+	) :_own(std::move(s)), _owns(true), _err_callback(f)
+	{
+		_src = _own;
+		_build();
+	}
+	// 文档持有文件映射（如 _basic_lazy_document(mapped_file(path))），不复制文件内容
+	explicit _basic_lazy_document(
+		mapped_file&& m,
+		const json_parse_error_callback_f& f = _sjson_detail::defult_parse_err_callback
+	) :_map(std::move(m)), _src(_map.view()), _err_callback(f)
+	{
+		_build();
+	}
+
+	_basic_lazy_document(const _basic_lazy_document&) = delete;
+	_basic_lazy_document& operator=(const _basic_lazy_document&) = delete;
+	_basic_lazy_document(_basic_lazy_document&& x) noexcept
+		:_own(std::move(x._own)), _owns(x._owns), _map(std::move(x._map)), _src(x._src),
+		_tokens(std::move(x._tokens)), _match(std::move(x._match)),
+		_err_callback(std::move(x._err_callback))
+	{
+		if (_owns)_src = _own;
+	}
+
+	// 根结点
+	node root()const { return { this, _tokens.empty() ? _npos : 0 }; }
+
+	node operator[](std::string_view key)const { return root()[key]; }
+	node operator[](size_t idx)const { return root()[idx]; }
+	template <typename _t>
+	node operator[](const _t* const key)const { return root()[key]; }
+	node at(std::string_view key)const { return root().at(key); }
+	node at(size_t idx)const { return root().at(idx); }
+	node at_pointer(const std::string& ptr)const { return root().at_pointer(ptr); }
+	template<typename _t>
+	_t get()const
+	{
+		const node r = root();
+		return r.get<_t>();
+	}
+	_json_t to_json()const { return root().to_json(); }
+
+private:
+
+	std::string _own;
+	bool _owns = false;
+	mapped_file _map; // 映射的地址不随移动改变
+	std::string_view _src;
+
+	std::vector<uint32_t> _tokens; // 各个值、键与括号的起始位置（不含 ',' ':'）
+	std::vector<uint32_t> _match; // 左括号对应的右括号的 token 序号，未闭合时为 _npos
+
+	json_parse_error_callback_f _err_callback;
+
+	char _ch(uint32_t i)const { return _src[_tokens[i]]; }
+
+	void _build()
+	{
+		if (_src.size() >= _sjson_detail::max_uint32)_JSON_THROW("lazy document input too large", 0);
+
+		_sjson_detail::structural_index index;
+		if (index.build(_src.data(), _src.size()))
 		{
-		case sjson::json_error_origin::parse_comment:
-			ss << "parse_comment";
-			break;
-		case sjson::json_error_origin::parse_string:
-			ss << "parse_string";
-			break;
-		case sjson::json_error_origin::parse_unicode:
-			ss << "parse_unicode";
-			break;
-		case sjson::json_error_origin::parse_keyword:
-			ss << "parse_keyword";
-			break;
-		case sjson::json_error_origin::parse_delimiter:
-			ss << "parse_delimiter";
-			break;
-		case sjson::json_error_origin::parse_array:
-			ss << "parse_array";
-			break;
-		case sjson::json_error_origin::parse_object:
-			ss << "parse_object";
-			break;
-		default:
-			break;
+			for (uint32_t pos : index.positions())
+			{
+				if (_src[pos] != ',' && _src[pos] != ':')_tokens.push_back(pos);
+			}
 		}
-		ss << ": ";
-		switch (e)
+		else
 		{
-		case sjson::json_parse_error::item_not_closed:
-			ss << "item_not_closed";
-			break;
-		case sjson::json_parse_error::illegal_escape:
-			ss << "illegal_escape";
-
-			break;
-		case sjson::json_parse_error::invalid_unicode_code:
-			ss << "invalid_unicode_code";
+			// 含有注释时逐个读取 token（不报告错误，错误在解析值时报告）
+			_parser_t p(_parser_t::defer, _src.data(), _src.size(), json_parse_error_callback_f());
+			while (true)
+			{
+				p._get_next_simple_node();
+				if (p._cur_node == _parser_t::_end_delimiter)break;
+				if (p._cur_node == _sjson_detail::parser_delimiter::comma
+					|| p._cur_node == _sjson_detail::parser_delimiter::colon
+					)continue;
+				_tokens.push_back(static_cast<uint32_t>(p._token_ofs));
+			}
+		}
 
-			break;
-		case sjson::json_parse_error::unknown_keyword:
-			ss << "unknown_keyword";
+		_match.assign(_tokens.size(), _npos);
+		std::vector<uint32_t> open;
+		for (uint32_t i = 0; i < _tokens.size(); ++i)
+		{
+			char ch = _ch(i);
+			if (ch == '[' || ch == '{')open.push_back(i);
+			else if ((ch == ']' || ch == '}') && !open.empty())
+			{
+				_match[open.back()] = i;
+				open.pop_back();
+			}
+		}
+	}
 
-			break;
-		case sjson::json_parse_error::unexpected_item:
-			ss << "unexpected_item";
+	// 值 i 之后的 token 序号
+	uint32_t _after(uint32_t i)const
+	{
+		if (i >= _tokens.size())return static_cast<uint32_t>(_tokens.size());
+		char ch = _ch(i);
+		if (ch != '[' && ch != '{')return i + 1;
+		return _match[i] == _npos ? static_cast<uint32_t>(_tokens.size()) : _match[i] + 1;
+	}
+	// token i 是否还在容器内（不是右括号也没有越界）
+	bool _in_container(uint32_t i)const
+	{
+		return i < _tokens.size() && _ch(i) != ']' && _ch(i) != '}';
+	}
 
-			break;
-		default:
-			break;
+	uint32_t _find_key(uint32_t obj, std::string_view key)const
+	{
+		if (_ch(obj) != '{')return _npos;
+		// 键重复时与 _get_next_node 一样取最后一个
+		uint32_t res = _npos;
+		for (uint32_t i = obj + 1; _in_container(i) && _ch(i) == '"'; i = _after(i + 1))
+		{
+			if (i + 1 < _tokens.size() && _key_equals(i, key))res = i + 1;
 		}
+		return res;
+	}
+	uint32_t _find_idx(uint32_t arr, size_t idx)const
+	{
+		if (_ch(arr) != '[')return _npos;
+		uint32_t i = arr + 1;
+		for (; idx && _in_container(i); --idx)i = _after(i);
+		return _in_container(i) ? i : _npos;
+	}
 
-		ss << ' ' << msg << '\n';
+	bool _key_equals(uint32_t i, std::string_view key)const
+	{
+		const char* beg = _src.data() + _tokens[i] + 1;
+		const char* end = _src.data() + _src.size();
+		const char* p = _sjson_detail::simd::find_string_special(beg, end);
+		if (p != end && *p == '"')return std::string_view(beg, p - beg) == key;
+		// 含有转义时解码后比较
+		const _json_t k = _decode(i);
+		return k.hold<_str_t>() && std::string_view(k.get<_str_t>()) == key;
+	}
 
-		std::cout << ss.str();
+	// 值 i 的原始文本的结尾
+	size_t _raw_end(uint32_t i)const
+	{
+		char ch = _ch(i);
+		if (ch == '[' || ch == '{')
+			return _match[i] == _npos ? _src.size() : _tokens[_match[i]] + 1;
+		_parser_t p(typename _parser_t::_range_t{}, _src.data(), _src.data() + _tokens[i], _src.data() + _src.size(), json_parse_error_callback_f());
+		p._get_next_simple_node();
+		return p._pos - _src.data();
+	}
 
-		return json_callback_ret::ignore_and_continue;
+	_json_t _decode(uint32_t i)const
+	{
+		_parser_t p(typename _parser_t::_range_t{}, _src.data(), _src.data() + _tokens[i], _src.data() + _src.size(), _err_callback);
+		p._get_next_node();
+		_json_t res;
+		res.swap(p._cur_node);
+		return res;
 	}
 };
 
-using json = _basic_json<>;
-
-inline json operator "" _json(const char* s, size_t n)
-{
-	return _sjson_detail::parser<json>(s, s + n).result();
-}
+using lazy_document = _basic_lazy_document<>;
 
 };
 
@@ -1,6 +1,14 @@
 ﻿#include <iostream>
+#if defined(_WIN32)
 #include <Windows.h>
+#endif
 #include <fstream>
+#include <sstream>
+#include <list>
+#include <limits>
+#include <thread>
+#include <atomic>
+#include <memory_resource>
 
 #define _SJSON_DISABLE_AUTO_TYPE_ADJUST
 
@@ -8,7 +16,899 @@
 
 using namespace sjson;
 
-int main()
+static int failures = 0;
+
+#define CHECK(x) \
+	do { if (!(x)) { std::cout << __FILE__ << ':' << __LINE__ << ": CHECK(" #x ") failed\n"; ++failures; } } while (0)
+
+// 记录解析错误而不打印
+struct error_log
+{
+	struct entry
+	{
+		uint32_t line, column;
+		json_error_origin origin;
+		json_parse_error e;
+		std::string msg;
+	};
+	std::vector<entry> errs;
+
+	json_parse_error_callback_f callback()
+	{
+		return [this](uint32_t line, uint32_t column, json_error_origin origin, json_parse_error e, const std::string& msg)
+			{
+				errs.push_back({ line, column, origin, e, msg });
+				return json_callback_ret::ignore_and_continue;
+			};
+	}
+};
+
+template<typename _json_t = json>
+static _json_t parse_str(std::string_view s)
+{
+	return _sjson_detail::parser<_json_t>(s).result();
+}
+
+// 连续内存按指针解析，与逐字符读取的结果相同
+static void test_contiguous_input()
+{
+	std::string s = R"({"a":[1,2.5,"x\ty",true,null],"b":{"c":"\u4e2d"}})";
+	json from_ptr = parse_str(s);
+	std::list<char> l(s.begin(), s.end());
+	json from_iter = _sjson_detail::parser<json>(l.begin(), l.end()).result();
+	CHECK(from_ptr == from_iter);
+	CHECK(from_ptr["a"][2].get<std::string>() == "x\ty");
+	CHECK(from_ptr["b"]["c"].get<std::string>() == "\xe4\xb8\xad");
+
+	// 多个顶层值组成数组
+	CHECK(parse_str("1 2 3").dump(0) == "[1,2,3]");
+
+	// 报错的行列号（行号从 0 开始）
+	error_log log;
+	_sjson_detail::parser<json>(std::string_view("[1,\n  nul]"), log.callback());
+	CHECK(log.errs.size() == 1 && log.errs[0].line == 1 && log.errs[0].column == 3 && log.errs[0].e == json_parse_error::unknown_keyword);
+}
+
+static void test_structural_index()
+{
+	// 每个 token 的起始偏移：结构字符、起始引号、标量的首字符；字符串中的内容与转义的引号不算
+	auto positions = [](std::string_view s)
+	{
+		_sjson_detail::structural_index idx;
+		CHECK(idx.build(s.data(), s.size()));
+		return idx.positions();
+	};
+	CHECK((positions(R"({ "a" : [1, "x\"y,]", true] })") == std::vector<uint32_t>{ 0, 2, 6, 8, 9, 10, 12, 20, 22, 26, 28 }));
+
+	// 跨越 64 字节的块：长字符串与连续的反斜杠
+	std::string s = "[\"" + std::string(70, '{') + "\\\\\",12]";
+	CHECK((positions(s) == std::vector<uint32_t>{ 0, 1, uint32_t(s.size() - 4), uint32_t(s.size() - 3), uint32_t(s.size() - 1) }));
+
+	// 字符串外的注释不建立索引
+	_sjson_detail::structural_index idx;
+	CHECK(!idx.build("[1,// c\n2]", 10));
+	CHECK(idx.build("[\"//\"]", 6));
+}
+
+static void test_string_scan()
+{
+	// 转义、引号与控制字符落在向量块的不同位置
+	for (size_t n = 0; n < 70; ++n)
+	{
+		std::string body(n, 'a');
+		json j = parse_str("[\"" + body + "\\n" + body + "\",\"" + body + "\"]");
+		CHECK(j[0].get<std::string>() == body + "\n" + body);
+		CHECK(j[1].get<std::string>() == body);
+
+		// 各种空白组成的长串
+		std::string ws;
+		for (size_t i = 0; i < n; ++i)ws += " \t\r\n"[i % 4];
+		CHECK(parse_str(ws + "[" + ws + "1" + ws + "," + ws + "2" + ws + "]" + ws).dump(0) == "[1,2]");
+
+		// 未转义的控制字符与旧实现一样原样接受
+		CHECK(parse_str("\"" + body + "\x01\"").get<std::string>() == body + "\x01");
+	}
+
+	// 非 ASCII 字节原样保留
+	std::string utf8 = "\xe4\xb8\xad\xe6\x96\x87\xe4\xb8\xad\xe6\x96\x87\xe4\xb8\xad\xe6\x96\x87\xe4\xb8\xad\xe6\x96\x87";
+	CHECK(parse_str("\"" + utf8 + "\"").get<std::string>() == utf8);
+}
+
+static void test_numbers()
+{
+	auto type_of = [](std::string_view s) { return parse_str(s).type(); };
+
+	// 整数按能容纳的最小类型保存
+	CHECK(type_of("2147483647") == json_value_t::num_i32);
+	CHECK(type_of("-2147483648") == json_value_t::num_i32);
+	CHECK(type_of("2147483648") == json_value_t::num_i64);
+	CHECK(type_of("-2147483649") == json_value_t::num_i64);
+	CHECK(type_of("9223372036854775807") == json_value_t::num_i64);
+	CHECK(type_of("9223372036854775808") == json_value_t::num_ui64);
+	CHECK(type_of("18446744073709551616") == json_value_t::num_double);
+	CHECK(parse_str("-9223372036854775808").get<int64_t>() == INT64_MIN);
+	CHECK(parse_str("18446744073709551615").get<uint64_t>() == UINT64_MAX);
+
+	// 浮点：快速路径与 from_chars 回退路径
+	CHECK(parse_str("0.1").get<double>() == 0.1);
+	CHECK(parse_str("-1.5e3").get<double>() == -1500.0);
+	CHECK(parse_str("1e-7").get<double>() == 1e-7);
+	CHECK(parse_str("123456789012345678901234567890").get<double>() == 123456789012345678901234567890.0);
+	CHECK(parse_str("2.2250738585072014e-308").get<double>() == 2.2250738585072014e-308);
+	CHECK(parse_str("1e400").get<double>() == std::numeric_limits<double>::infinity());
+	CHECK(parse_str("1e-400").get<double>() == 0.0);
+
+	// 缺少数字时报告 parse_number 错误
+	error_log log;
+	_sjson_detail::parser<json>(std::string_view("[-]"), log.callback());
+	CHECK(!log.errs.empty() && log.errs[0].origin == json_error_origin::parse_number);
+}
+
+static void test_istream_blocks()
+{
+	// 每次只读一个值，多读的部分退回流中
+	std::istringstream ss("1 [2, 3] {\"a\":4} tail");
+	json a, b, c;
+	ss >> a >> b >> c;
+	std::string rest;
+	ss >> rest;
+	CHECK(a.dump(0) == "1" && b.dump(0) == "[2,3]" && c.dump(0) == R"({"a":4})" && rest == "tail");
+
+	// 无法退回字符的流：报告失败，而不是留下缺了一段的数据
+	struct no_putback_buf : std::streambuf
+	{
+		std::string data;
+		size_t off = 0;
+		explicit no_putback_buf(std::string s) :data(std::move(s)) {}
+		int_type underflow()override { return off < data.size() ? traits_type::to_int_type(data[off]) : traits_type::eof(); }
+		int_type uflow()override { return off < data.size() ? traits_type::to_int_type(data[off++]) : traits_type::eof(); }
+	};
+	no_putback_buf buf("12 34");
+	std::istream is(&buf);
+	json n;
+	is >> n;
+	CHECK(n.get<int>() == 12);
+	CHECK(is.fail());
+	CHECK(buf.off == 3);
+}
+
+// 把 SAX 事件记录为文本
+struct sax_log
+{
+	std::string text;
+	bool start_object() { text += '{'; return true; }
+	bool end_object() { text += '}'; return true; }
+	bool start_array() { text += '['; return true; }
+	bool end_array() { text += ']'; return true; }
+	bool key(std::string_view k) { text += "k:" + std::string(k) + ' '; return true; }
+	bool string(std::string_view s) { text += "s:" + std::string(s) + ' '; return true; }
+	bool number_int64(int64_t x) { text += "i:" + std::to_string(x) + ' '; return true; }
+	bool number_uint64(uint64_t x) { text += "u:" + std::to_string(x) + ' '; return true; }
+	bool number_double(double x) { text += "d:" + std::to_string(x) + ' '; return true; }
+	bool boolean(bool x) { text += x ? "true " : "false "; return true; }
+	bool null() { text += "null "; return true; }
+};
+
+static void test_sax()
+{
+	std::string s = R"({"plain":"abc","esc\"aped":"x\ny\u4e2d","n":[-1,18446744073709551615,2.5,true,null]})";
+	const std::string expect = "{k:plain s:abc k:esc\"aped s:x\ny\xe4\xb8\xad k:n [i:-1 u:18446744073709551615 d:2.500000 true null ]}";
+
+	sax_log a;
+	CHECK(sax_parse(s, a));
+	CHECK(a.text == expect);
+
+	// 流输入时字符串可能跨越读取块，同样得到完整的内容
+	std::istringstream is(s);
+	sax_log b;
+	CHECK(sax_parse(is, b));
+	CHECK(b.text == expect);
+
+	// 原样保存数字时事件相同
+	sax_log c;
+	_sjson_detail::parser<json> p(_sjson_detail::parser<json>::defer, std::string_view(s));
+	p.set_raw_numbers(true);
+	CHECK(p.parse_sax(c));
+	CHECK(c.text == expect);
+
+	// 错误恢复后 start/end 仍然成对
+	sax_log d;
+	error_log log;
+	sax_parse(std::string_view(R"([1,{"a":[2,)"), d, log.callback());
+	CHECK(d.text == "[i:1 {k:a [i:2 ]}]");
+	CHECK(!log.errs.empty());
+}
+
+static void test_cursor_numbers()
+{
+	for (bool raw : { false, true })
+	{
+		_sjson_detail::parser<json> p(_sjson_detail::parser<json>::defer,
+			std::string_view(R"([2.0, 3.7, 300, -1, 1e300, 99999999999999999999, "x"])"));
+		p.set_raw_numbers(raw);
+		CHECK(p.next() == json_token::start_array);
+
+		p.next();
+		CHECK(p.get_number<int>() == 2 && p.get_number<double>() == 2.0);
+
+		// 非整数不能读为整数
+		p.next();
+		int i = -5;
+		CHECK(!p.get_number(i) && i == -5);
+		CHECK(p.get_number<double>() == 3.7);
+
+		// 超出范围
+		p.next();
+		uint8_t u8 = 0;
+		CHECK(!p.get_number(u8));
+		CHECK(p.get_number<int16_t>() == 300);
+
+		p.next();
+		unsigned u = 0;
+		CHECK(!p.get_number(u));
+		CHECK(p.get_number<int>() == -1);
+
+		p.next();
+		float f = 0;
+		CHECK(!p.get_number(f) && !p.get_number(i));
+		bool thrown = false;
+		try { p.get_number<int64_t>(); }
+		catch (const json_error& e) { thrown = e.error_code() == 0; }
+		CHECK(thrown);
+
+		p.next();
+		uint64_t u64 = 0;
+		CHECK(!p.get_number(u64));
+		CHECK(p.get_number<double>() == 1e20);
+
+		// 不是数字
+		p.next();
+		thrown = false;
+		try { p.get_number<int>(); }
+		catch (const json_error& e) { thrown = e.error_code() == 1; }
+		CHECK(thrown);
+	}
+}
+
+static void test_ndjson()
+{
+	std::string s = "{\"a\":1}\n[2]\n\n\"three\" 4 , null\n";
+	std::vector<std::string> seen;
+	CHECK(for_each_value(s, [&](json& j) { seen.push_back(j.dump(0)); }) == 5);
+	CHECK((seen == std::vector<std::string>{ R"({"a":1})", "[2]", "\"three\"", "4", "null" }));
+
+	// 提前停止时未读取的部分留在流中
+	std::istringstream is(s);
+	size_t n = for_each_value(is, [](json& j) { return j.type() != json_value_t::array; });
+	CHECK(n == 2);
+	json rest;
+	is >> rest;
+	CHECK(rest.get<std::string>() == "three");
+
+	// 跨越读取块的长记录
+	std::string big;
+	for (int i = 0; i < 3000; ++i)big += "{\"id\":" + std::to_string(i) + ",\"pad\":\"" + std::string(40, 'x') + "\"}\n";
+	std::istringstream bs(big);
+	int64_t sum = 0;
+	CHECK(for_each_value(bs, [&](json& j) { sum += j["id"].get<int>(); }) == 3000);
+	CHECK(sum == 2999 * 3000 / 2);
+}
+
+static void test_parallel()
+{
+	// 足够切分为多段的根数组，元素中含有括号、逗号与转义引号
+	std::string s = "[";
+	for (int i = 0; i < 80000; ++i)
+		s += std::string(i ? "," : "") + R"({"i":)" + std::to_string(i) + R"(,"s":"],[{\"x\"}",)" + R"("v":[1,[2,{"w":null}]]})";
+	s += "]";
+	CHECK(s.size() > (size_t(3) << 20));
+	json serial = parse_str(s);
+	CHECK(parse_parallel(s, 4) == serial);
+	CHECK(parse_parallel(s, 1) == serial);
+
+	// 不是单个数组、含注释或有错误时退化为串行解析
+	CHECK(parse_parallel(std::string_view(R"({"a":[1,2]})"), 4).dump(0) == R"({"a":[1,2]})");
+	std::string commented = "/* c */" + s;
+	CHECK(parse_parallel(commented, 4) == serial);
+	error_log log;
+	std::string broken = s.substr(0, s.size() / 2) + "]";
+	json a = parse_parallel(broken, 4, log.callback());
+	error_log log2;
+	json b = _sjson_detail::parser<json>(std::string_view(broken), log2.callback()).result();
+	CHECK(a == b && log.errs.size() == log2.errs.size());
+}
+
+static void test_push()
+{
+	std::string s = R"({"a":[1,2.5,"x\"y\u4e2d"],"b":{"c":true,"d":null}} [[[]]] "tail" 42)";
+	std::vector<json> expect;
+	for_each_value(s, [&](json& j) { expect.push_back(j); });
+
+	// 逐字节推送
+	_sjson_detail::parser<json> p(_sjson_detail::parser<json>::push);
+	std::vector<json> got;
+	for (char ch : s)
+	{
+		auto st = p.feed(std::string_view(&ch, 1));
+		while (st == json_feed_status::done)
+		{
+			got.push_back(p.result());
+			st = p.feed(std::string_view());
+		}
+		CHECK(st == json_feed_status::need_more);
+	}
+	json_feed_status st;
+	while ((st = p.finish()) == json_feed_status::done)got.push_back(p.result());
+	CHECK(st == json_feed_status::end);
+	CHECK(got == expect);
+
+	// 重置后复用，深层嵌套
+	p.reset();
+	std::string deep = std::string(500, '[') + std::string(500, ']');
+	CHECK(p.feed(deep.substr(0, 300)) == json_feed_status::need_more);
+	CHECK(p.feed(deep.substr(300)) == json_feed_status::done);
+	CHECK(p.result().dump(0) == deep);
+}
+
+static void test_lazy_document()
+{
+	std::string s = R"({"a":[1,{"b":"x,]}"},3.5],"k\"q":true,"a~/":null,"dup":1,"dup":2,"n":18446744073709551615})";
+	lazy_document doc(s);
+	CHECK(doc.to_json() == parse_str(s));
+
+	CHECK(doc["a"].type() == json_value_t::array && doc["a"].size() == 3);
+	CHECK(doc["a"][1]["b"].get<std::string>() == "x,]}");
+	CHECK(doc["a"][2].get<double>() == 3.5);
+	CHECK(doc["a"][1].raw() == R"({"b":"x,]}"})");
+	CHECK(doc["k\"q"].get<bool>());
+	CHECK(doc.at_pointer("/a~0~1").exists() && doc.at_pointer("/a~0~1").type() == json_value_t::null);
+	CHECK(doc.at_pointer("/a/1/b").get<std::string>() == "x,]}");
+	CHECK(doc["dup"].get<int>() == 2);
+	CHECK(doc["n"].type() == json_value_t::num_ui64);
+
+	// 不存在的值
+	CHECK(!doc["missing"].exists() && !doc["a"][7].exists() && !doc.at_pointer("/a/x").exists());
+	bool thrown = false;
+	try { doc.at("missing"); }
+	catch (const json_error&) { thrown = true; }
+	CHECK(thrown);
+
+	// 遍历
+	std::string raws;
+	for (auto x : doc["a"])raws += std::string(x.raw()) + ';';
+	CHECK(raws == R"(1;{"b":"x,]}"};3.5;)");
+
+	// 含注释时退化为逐个 token 遍历
+	lazy_document commented(std::string(R"(/* c */ {"a": [1, // x
+		2]})"));
+	CHECK(commented["a"][1].get<int>() == 2);
+}
+
+static void test_in_place()
+{
+	std::string s = R"({"plain":"abc","esc":"a\tb\u4e2dc","k\"ey":[1,"x"]})";
+	const std::string copy = s;
+	json_view v = parse_in_place(s);
+	CHECK(v.dump(0) == parse_str(copy).dump(0));
+
+	// 不含转义的字符串直接引用输入
+	auto plain = v["plain"].get<std::string_view>();
+	CHECK(plain == "abc" && plain.data() >= s.data() && plain.data() < s.data() + s.size());
+	CHECK(v["esc"].get<std::string_view>() == "a\tb\xe4\xb8\xad" "c");
+	CHECK(v["k\"ey"][1].get<std::string_view>() == "x");
+}
+
+static void test_string_pool()
+{
+	// 长度不超过 max_len 的键与值放入池中，相同的内容共用同一份存储
+	std::string s = R"([{"name":"n1","long":"0123456789"},{"name":"n1","long":"0123456789"}])";
+	string_pool pool;
+	json_view v = parse_in_place(s, pool, 4);
+	CHECK(v[0]["name"].get<std::string_view>().data() == v[1]["name"].get<std::string_view>().data());
+	CHECK(v[0]["long"].get<std::string_view>().data() != v[1]["long"].get<std::string_view>().data());
+	CHECK(v.dump(0) == parse_str(s).dump(0));
+	// "name"、"long"、"n1" 各存一份
+	CHECK(pool.size() == 3 && pool.hits() == 3);
+
+	// 池中的字符串在输入被修改后仍然有效
+	std::fill(s.begin(), s.end(), ' ');
+	CHECK(v[1]["name"].get<std::string_view>() == "n1");
+	pool.clear();
+	CHECK(pool.size() == 0 && pool.lookups() == 0);
+}
+
+struct bind_item
+{
+	int id = 0;
+	uint8_t level = 0;
+	double score = 0;
+	std::string name;
+	std::vector<int> tags;
+	std::optional<std::string> note;
+};
+SJSON_BIND(bind_item, id, level, score, name, tags, note)
+
+struct bind_view_item
+{
+	std::string_view name;
+	int id = 0;
+};
+SJSON_BIND(bind_view_item, name, id)
+
+static void test_bind()
+{
+	bind_item x;
+	CHECK(parse_into(R"({"id":7,"level":200,"score":1.5,"name":"a\tb","tags":[1,2],"note":"n","extra":[{}]})", x));
+	CHECK(x.id == 7 && x.level == 200 && x.score == 1.5 && x.name == "a\tb");
+	CHECK(x.tags == std::vector<int>({ 1, 2 }) && x.note == "n");
+	CHECK(dump_bound(x) == R"({"id":7,"level":200,"score":1.5,"name":"a\tb","tags":[1,2],"note":"n"})");
+
+	// 小数读入整数、超出范围的数字报告 bind_value 错误，成员保持不变，其余成员照常读取
+	error_log log;
+	bind_item y;
+	y.id = 5;
+	CHECK(parse_into(R"({"id":3.7,"level":300,"name":"ok","tags":[1,1e300,-1]})", y, log.callback()));
+	CHECK(y.id == 5 && y.level == 0 && y.name == "ok" && y.tags == std::vector<int>({ 1, -1 }));
+	CHECK(log.errs.size() == 3);
+	for (auto& e : log.errs)
+		CHECK(e.origin == json_error_origin::bind_value && e.e == json_parse_error::unexpected_item);
+	CHECK(log.errs.size() == 3 && log.errs[1].msg.find("[0, 255]") != std::string::npos);
+
+	// 整数形式的小数与范围内的数字可以读入
+	bind_item z;
+	CHECK(parse_into(R"({"id":-2.0,"level":255})", z) && z.id == -2 && z.level == 255);
+
+	// string_view 成员只能原地解析，引用输入
+	std::string s = R"({"name":"abc","id":1})";
+	bind_view_item v;
+	CHECK(parse_into_in_place(s, v) && v.name == "abc" && v.id == 1);
+	CHECK(v.name.data() >= s.data() && v.name.data() < s.data() + s.size());
+}
+
+static void test_projection()
+{
+	std::string s = R"({"a":{"x":1,"y":[10,{"z":"q"},30]},"b":"skip\"}","c":[true,false],"d":null})";
+	json p = parse_projection(std::string_view(s), std::vector<std::string>{ "/a/y/1/z", "/c", "/missing", "bad" });
+	CHECK(p == parse_str(R"({"a":{"y":[null,{"z":"q"}]},"c":[true,false]})"));
+
+	// 重复的键与 parse 一样取最后一个，后面的值没有请求的路径时去掉前面读到的值
+	auto proj = [](const char* text, std::vector<std::string> ptrs) { return parse_projection(std::string_view(text), ptrs); };
+	CHECK(proj(R"({"a":1,"a":2,"b":3})", { "/a", "/b" }) == parse_str(R"({"a":2,"b":3})"));
+	CHECK(proj(R"({"a":1,"b":3,"a":2})", { "/a", "/b" }) == parse_str(R"({"a":2,"b":3})"));
+	CHECK(proj(R"({"a":{"x":1},"a":{"y":2},"b":3})", { "/a/y", "/b" }) == parse_str(R"({"a":{"y":2},"b":3})"));
+	CHECK(proj(R"({"a":{"y":1},"a":{"x":2},"b":3})", { "/a/y", "/b" }) == parse_str(R"({"b":3})"));
+	CHECK(proj(R"({"a":{"b":{"x":1},"b":5}})", { "/a/b/x" }).type() == json_value_t::null);
+	// 不存在的路径不出现
+	CHECK(proj(R"({"a":5,"b":3})", { "/a/x", "/b" }) == parse_str(R"({"b":3})"));
+	CHECK(proj(R"({"a":[1,2]})", { "/a/5" }).type() == json_value_t::null);
+	CHECK(proj(R"({"a":null})", { "/a" }) == parse_str(R"({"a":null})"));
+	// 结点多到前缀树重新分配
+	CHECK(proj(R"({"a":1,"b":2,"c":3,"d":4,"e":5})", { "/a", "/b", "/c", "/d", "/e" }) == parse_str(R"({"a":1,"b":2,"c":3,"d":4,"e":5})"));
+	CHECK(parse_projection(std::string_view(R"([[1,2],[3,4],[5,6]])"), std::vector<std::string>{ "/0/1", "/2/0" }) == parse_str("[[null,2],null,[5]]"));
+}
+
+static void test_mapped_file()
+{
+	const std::string path = "sjson_test_mapped.json";
+	const std::string text = R"({"a":[1,2,3],"s":"x\ny"})";
+	std::ofstream(path, std::ios::binary) << text;
+
+	CHECK(parse_file(path) == parse_str(text));
+
+	// 以 copy_on_write 映射后原地解析，改写不影响文件
+	{
+		mapped_file m(path, true);
+		CHECK(m.writable() && m.view() == text);
+		json_view v = parse_in_place(m);
+		CHECK(v["s"].get<std::string_view>() == "x\ny");
+	}
+	CHECK(mapped_file(path).view() == text);
+
+	// 空文件与打不开的文件
+	std::ofstream(path, std::ios::binary | std::ios::trunc).close();
+	CHECK(mapped_file(path).size() == 0);
+	std::remove(path.c_str());
+	bool thrown = false;
+	try { mapped_file m(path); }
+	catch (const json_error&) { thrown = true; }
+	CHECK(thrown);
+}
+
+static void test_move_construction()
+{
+	// 移动构造与 push_back 不复制字符串
+	std::string long_str(100, 'x');
+	const char* buf = long_str.data();
+	json s(std::move(long_str));
+	CHECK(s.get<std::string>().data() == buf);
+	json arr(json_value_t::array);
+	arr.push_back(std::move(s));
+	CHECK(arr[0].get<std::string>().data() == buf);
+	json moved = std::move(arr);
+	CHECK(moved.size() == 1 && moved[0].get<std::string>().data() == buf);
+
+	// 深层嵌套的数组与对象，每层都只构建一次
+	const int depth = 1000;
+	std::string text;
+	for (int i = 0; i < depth; ++i)text += i % 2 ? R"({"k":)" : "[";
+	text += R"("leaf")";
+	for (int i = depth; i-- > 0;)text += i % 2 ? "}" : "]";
+	json deep = _sjson_detail::parser<json>(std::string_view(text)).result();
+	const json* at = &deep;
+	for (int i = 0; i < depth; ++i)
+		at = i % 2 ? &(*at)["k"] : &(*at)[0];
+	CHECK(at->get<std::string>() == "leaf");
+	CHECK(deep.dump(0) == text);
+
+	// 多个顶层值移入结果数组
+	_sjson_detail::parser<json> p(std::string_view(R"([1] {"a":[2]} "s")"));
+	json all = std::move(p).result();
+	CHECK(all == parse_str(R"([[1],{"a":[2]},"s"])"));
+}
+
+static void test_depth_limit()
+{
+	// 超过限制的容器报告 too_deep，按括号匹配跳过并当作 null，其后的值照常解析
+	error_log log;
+	_sjson_detail::parser<json> p(_sjson_detail::parser<json>::defer, std::string_view(), log.callback());
+	p.set_max_depth(3);
+	CHECK(p.parse(R"([[[[1]],{"a":{"b":{}}}],2])") == parse_str(R"([[[null],{"a":null}],2])"));
+	CHECK(log.errs.size() == 2 && log.errs[0].e == json_parse_error::too_deep && log.errs[0].msg == "3");
+	CHECK(log.errs.size() == 2 && log.errs[0].origin == json_error_origin::parse_array && log.errs[1].origin == json_error_origin::parse_object);
+
+	// 逐个读取 token 时同样限制
+	log.errs.clear();
+	_sjson_detail::parser<json> c(_sjson_detail::parser<json>::defer, std::string_view("[[1],[[2]],3]"), log.callback());
+	c.set_max_depth(2);
+	std::vector<json_token> toks;
+	for (json_token tk; (tk = c.next()) != json_token::end;)toks.push_back(tk);
+	CHECK(toks.size() == 9 && toks[5] == json_token::value && log.errs.size() == 1);
+
+	// 默认的限制使极深的输入不会耗尽栈
+	log.errs.clear();
+	std::string deep = std::string(100000, '[') + std::string(100000, ']');
+	json j = _sjson_detail::parser<json>(std::string_view(deep), log.callback()).result();
+	CHECK(log.errs.size() == 1 && log.errs[0].e == json_parse_error::too_deep);
+
+	// 0 表示不限制
+	p.set_max_depth(0);
+	CHECK(p.parse("[[[[[[1]]]]]]").dump(0) == "[[[[[[1]]]]]]");
+}
+
+static size_t utf8_errors(const error_log& log, const std::string& at)
+{
+	return std::count_if(log.errs.begin(), log.errs.end(), [&](const error_log::entry& x)
+		{
+			return x.origin == json_error_origin::validate_utf8 && x.e == json_parse_error::invalid_utf8 && x.msg == at;
+		});
+}
+
+static void test_utf8_validation()
+{
+	CHECK(validate_utf8("a\xe4\xb8\xad\xf0\x9f\x98\x80") == std::string_view::npos);
+	CHECK(validate_utf8("ab\xe4\xb8") == 2); // 截断
+	CHECK(validate_utf8("\xc0\xaf") == 0); // 过长编码
+	CHECK(validate_utf8("x\xed\xa0\x80") == 1); // 代理项
+	CHECK(validate_utf8("\xf4\x90\x80\x80") == 0); // 超出 U+10FFFF
+
+	using p_t = _sjson_detail::parser<json>;
+	error_log log;
+	p_t whole(p_t::defer, std::string_view("[\"a\xff\"]"), log.callback());
+	CHECK(!whole.validate_utf8());
+	CHECK(log.errs.size() == 1 && utf8_errors(log, "3") == 1);
+
+	// 流：多字节序列跨越读取块的边界，每块读入时校验
+	std::string text = "[\"";
+	while (text.size() < (3 << 16))text += "\xe4\xb8\xad";
+	text += "\"]";
+	for (int shift = 0; shift < 3; ++shift)
+	{
+		log.errs.clear();
+		std::istringstream is(std::string(shift, ' ') + text);
+		p_t p(p_t::defer, is, log.callback());
+		CHECK(p.validate_utf8());
+		p.parse();
+		CHECK(log.errs.empty() && p.result()[0].get<std::string>().size() == text.size() - 4);
+	}
+
+	// 不合法的字节位于第一块之后，偏移相对输入开头
+	std::string bad = text;
+	bad[100000] = '\xff';
+	log.errs.clear();
+	{
+		std::istringstream is(bad);
+		p_t p(p_t::defer, is, log.callback());
+		CHECK(p.validate_utf8());
+		p.parse();
+		CHECK(utf8_errors(log, std::to_string(validate_utf8(bad))) == 1);
+	}
+
+	// 输入结束时仍不完整的序列
+	log.errs.clear();
+	{
+		std::istringstream is("[\"a\"] \"\xe4\xb8");
+		p_t p(p_t::defer, is, log.callback());
+		CHECK(p.validate_utf8());
+		p.parse();
+		CHECK(utf8_errors(log, "7") == 1);
+	}
+
+	// 推送：逐字节推送合法的输入，之后推送不合法的字节
+	log.errs.clear();
+	p_t push(p_t::push, log.callback());
+	CHECK(push.validate_utf8());
+	std::string head = "[\"\xe4\xb8\xad\xf0\x9f\x98\x80\",";
+	for (char ch : head)CHECK(push.feed(std::string_view(&ch, 1)) == json_feed_status::need_more);
+	CHECK(log.errs.empty());
+	push.feed("\"\xe4\xb8\xe4\"]");
+	CHECK(log.errs.size() == 1 && utf8_errors(log, std::to_string(head.size() + 1)) == 1);
+
+	// 推送：finish 时末尾不完整的序列
+	log.errs.clear();
+	push.reset();
+	CHECK(push.validate_utf8());
+	push.feed("1 \xf0\x9f");
+	push.finish();
+	CHECK(utf8_errors(log, "2") == 1);
+}
+
+static void test_parser_pool()
+{
+	using pool_t = _sjson_detail::parser_pool<json>;
+	const void* first = nullptr;
+	{
+		auto p = pool_t::acquire();
+		first = &*p;
+		p->set_max_depth(1);
+		p->set_raw_numbers(true);
+		CHECK(p->parse("[1]").dump(0) == "[1]");
+	}
+	// 放回时恢复默认设置
+	{
+		auto p = pool_t::acquire();
+		CHECK(&*p == first);
+		error_log log;
+		p->set_error_callback(log.callback());
+		json& j = p->parse("[[12]]");
+		CHECK(log.errs.empty() && j[0][0].type() != json_value_t::num_raw);
+		// 嵌套使用时取得不同的解析器
+		auto q = pool_t::acquire();
+		CHECK(&*q != &*p);
+	}
+	CHECK(parse_pooled(R"({"a":[1,2]})") == parse_str(R"({"a":[1,2]})"));
+
+	// 借用者设置的内存资源不会留给下一个借用者
+	using pmr_pool_t = _sjson_detail::parser_pool<pmr_json>;
+	{
+		std::pmr::monotonic_buffer_resource res;
+		auto p = pmr_pool_t::acquire();
+		p->set_memory_resource(&res);
+		CHECK(p->parse(R"(["a long string that needs an allocation"])").get_allocator().resource() == &res);
+	}
+	{
+		auto p = pmr_pool_t::acquire();
+		CHECK(p->parse(R"(["a long string that needs an allocation"])").get_allocator().resource() == std::pmr::get_default_resource());
+	}
+}
+
+static void test_raw_numbers()
+{
+	const std::string s = R"([123456789012345678,-123456789012345678,1234567890123456789,18446744073709551615,0.1000000000000000055511151231257827,1E+2,-0,3000000000])";
+	_sjson_detail::parser<json> p;
+	p.set_raw_numbers(true);
+	const json j = p.parse(s);
+
+	// 原样写回
+	CHECK(j.dump(0) == s);
+	CHECK(j[0].type() == json_value_t::num_raw);
+
+	// 不超过 18 位的整数走快速路径，更长的整数按范围转换
+	CHECK(j[0].get<int64_t>() == 123456789012345678);
+	CHECK(j[1].get<int64_t>() == -123456789012345678);
+	CHECK(j[2].get<int64_t>() == 1234567890123456789);
+	CHECK(j[3].get<uint64_t>() == std::numeric_limits<uint64_t>::max());
+	CHECK(j[4].get<double>() == 0.1 && j[5].get<double>() == 100.0);
+	CHECK(j[6].get<int32_t>() == 0 && j[7].get<uint32_t>() == 3000000000u);
+
+	// const 读取不修改 json，多个线程可以同时读取
+	std::vector<std::thread> threads;
+	std::atomic<int> bad{ 0 };
+	for (int t = 0; t < 4; ++t)
+	{
+		threads.emplace_back([&]()
+			{
+				for (int k = 0; k < 1000; ++k)
+				{
+					if (j[0].get<int64_t>() != 123456789012345678 || j[4].get<double>() != 0.1)++bad;
+				}
+			});
+	}
+	for (auto& t : threads)t.join();
+	CHECK(bad == 0 && j[0].type() == json_value_t::num_raw && j.dump(0) == s);
+
+	// 非 const 读取同样不修改结点，dump 仍输出原文；不能转换时也不调整类型
+	json m = j;
+	CHECK(m[7].get<uint32_t>() == 3000000000u && m[0].get<json_value_t::num_i64>() == 123456789012345678);
+	bool thrown = false;
+	try { m[4].get<int32_t>(); }
+	catch (const json_error&) { thrown = true; }
+	CHECK(thrown);
+	CHECK(m[7].type() == json_value_t::num_raw && m[4].type() == json_value_t::num_raw && m.dump(0) == s);
+
+	// 修改数字直接赋值
+	m[7] = 5;
+	CHECK(m[7].get<int>() == 5 && m[7].type() == json_value_t::num_i32);
+}
+
+static void test_compact()
+{
+	static_assert(sizeof(compact_json) == 16);
+
+	const std::string s = R"({"id":-7,"big":18446744073709551615,"pi":3.25,"ok":true,"n":null,"short":"fifteen bytes!!","long":"sixteen bytes!!!","arr":[1,[2,{}],"x"]})";
+	compact_json c = parse_compact(s);
+	CHECK(c.type() == json_value_t::object && c.size() == 8);
+	CHECK(c["id"].get<int>() == -7 && c["big"].get<uint64_t>() == std::numeric_limits<uint64_t>::max());
+	CHECK(c["pi"].get<double>() == 3.25 && c["ok"].get<bool>() && c["n"].type() == json_value_t::null);
+	CHECK(c["short"].get<std::string_view>() == "fifteen bytes!!" && c["long"].get<std::string>() == "sixteen bytes!!!");
+	CHECK(c["arr"][1][0].get<int>() == 2 && c.find("missing") == nullptr);
+
+	// 与 json 相互转换，dump 与 json::dump(0) 相同（对象保持插入顺序）
+	CHECK(c.to_json() == parse_str(s));
+	CHECK(c.dump() == s);
+	CHECK(compact_json::from_json(parse_str(s)).to_json() == parse_str(s));
+
+	// 原样保存的数字在 from_json 时转换
+	_sjson_detail::parser<json> p;
+	p.set_raw_numbers(true);
+	compact_json r = compact_json::from_json(p.parse("[12345678901234567890,1.5e3]"));
+	CHECK(r[0].get<uint64_t>() == 12345678901234567890ull && r[1].get<double>() == 1500.0);
+
+	// 修改与复制
+	compact_json arr(json_value_t::array);
+	arr.push_back("a string longer than fifteen bytes");
+	arr.push_back(compact_json(json_value_t::object));
+	arr[1].emplace("k", 1);
+	arr[1]["k2"] = false;
+	compact_json copy = arr;
+	arr[0] = 0;
+	CHECK(copy.dump() == R"(["a string longer than fifteen bytes",{"k":1,"k2":false}])");
+	CHECK(arr.dump() == R"([0,{"k":1,"k2":false}])");
+}
+
+// 记录分配次数的内存资源
+struct counting_resource :std::pmr::memory_resource
+{
+	size_t allocs = 0;
+	std::pmr::memory_resource* up = std::pmr::new_delete_resource();
+
+	void* do_allocate(size_t n, size_t align) override { ++allocs; return up->allocate(n, align); }
+	void do_deallocate(void* p, size_t n, size_t align) override { up->deallocate(p, n, align); }
+	bool do_is_equal(const std::pmr::memory_resource& x)const noexcept override { return this == &x; }
+};
+
+static void test_pmr()
+{
+	const std::string s = R"({"name":"a string that does not fit in SSO","list":[1,"another long string value here",{"k":[true]}]})";
+
+	// 整个文档都从 res 分配，默认资源不被使用
+	std::pmr::monotonic_buffer_resource res;
+	auto* old = std::pmr::set_default_resource(std::pmr::null_memory_resource());
+	pmr_json j = parse_pmr(s, &res);
+	std::pmr::set_default_resource(old);
+	CHECK(j.get_allocator().resource() == &res);
+	CHECK(j["list"][2]["k"].get_allocator().resource() == &res);
+	CHECK(j.dump(0) == parse_str(s).dump(0));
+
+	// operator[]、push_back 与初始化列表沿用结点的资源
+	counting_resource a, b;
+	pmr_json x(std::allocator_arg, &a, json_value_t::object);
+	x["new key that is long enough"] = "a value that is long enough to allocate";
+	x["arr"] = json_value_t::array;
+	x["arr"].push_back(pmr_json("pushed string that is long enough to allocate"));
+	pmr_json y(std::allocator_arg, &b, { {"from", "initializer list with a long string"}, {"n", 1} });
+	CHECK(x["arr"].get_allocator().resource() == &a && y["from"].get_allocator().resource() == &b);
+	size_t b_allocs = b.allocs;
+
+	// 赋值时复制到自己的资源中
+	pmr_json z(std::allocator_arg, &b);
+	z = x;
+	CHECK(z.get_allocator().resource() == &b && b.allocs > b_allocs);
+
+	// 资源不同时交换内容，各自保持自己的资源
+	const std::string xd = x.dump(0), yd = y.dump(0);
+	x.swap(y);
+	CHECK(x.dump(0) == yd && y.dump(0) == xd);
+	CHECK(x.get_allocator().resource() == &a && x["from"].get_allocator().resource() == &a);
+	CHECK(y.get_allocator().resource() == &b && y["arr"].get_allocator().resource() == &b);
+
+	// 资源相同时直接交换，不再分配
+	pmr_json w(std::allocator_arg, &a, json_value_t::array);
+	w.push_back(pmr_json(std::allocator_arg, &a, "a long string that lives in resource a"));
+	size_t a_allocs = a.allocs;
+	w.swap(x);
+	CHECK(a.allocs == a_allocs && w.dump(0) == yd && x[0].get<std::pmr::string>() == "a long string that lives in resource a");
+}
+
+static void test_flat_map()
+{
+	using map_t = flat_map<std::string, int>;
+	map_t m;
+	// 摘要（长度与首、中、尾字符）相同的键
+	CHECK(m.try_emplace("abXcd", 1).second && m.try_emplace("abYcd", 2).second);
+	CHECK(!m.try_emplace("abXcd", 9).second && m["abXcd"] == 1 && m.at("abYcd") == 2);
+	CHECK(m.find("abZcd") == m.end() && m.count("abYcd") == 1);
+
+	// 超过 linear_max 后建立哈希索引，插入顺序不变
+	for (int i = 0; i < 100; ++i)m["k" + std::to_string(i)] = i;
+	CHECK(m.size() == 102 && m.begin()->first == "abXcd" && (m.end() - 1)->first == "k99");
+	bool all = true;
+	for (int i = 0; i < 100; ++i)all = all && m.contains("k" + std::to_string(i)) && m.find("k" + std::to_string(i))->second == i;
+	CHECK(all && !m.contains("k100"));
+
+	// erase 保持顺序，之后查找仍然正确
+	CHECK(m.erase("k50") == 1 && m.erase("k50") == 0);
+	m.erase(m.begin());
+	CHECK(m.size() == 100 && m.begin()->first == "abYcd" && !m.contains("abXcd") && m["k51"] == 51);
+	CHECK((m.begin() + 50)->first == "k49" && (m.begin() + 51)->first == "k51");
+
+	// 与 std::unordered_map 相同，比较与顺序无关
+	map_t a{ {"x", 1}, {"y", 2} }, b{ {"y", 2}, {"x", 1} };
+	CHECK(a == b);
+	b["x"] = 3;
+	CHECK(!(a == b));
+	bool thrown = false;
+	try { std::as_const(a).at("z"); }
+	catch (const std::out_of_range&) { thrown = true; }
+	CHECK(thrown);
+
+	// flat_json 按插入顺序 dump
+	const std::string s = R"({"z":1,"a":{"m":[1,2],"b":null},"k":"v"})";
+	flat_json f = parse_str<flat_json>(s);
+	CHECK(f.dump(0) == s && f["a"]["m"][1].get<int>() == 2);
+	f["new"] = true;
+	CHECK(f.dump(0) == R"({"z":1,"a":{"m":[1,2],"b":null},"k":"v","new":true})");
+}
+
+static void test_swiss_map()
+{
+	using map_t = swiss_map<std::string, int>;
+	map_t m;
+	for (int i = 0; i < 5000; ++i)CHECK(m.try_emplace("key" + std::to_string(i), i).second);
+	CHECK(m.size() == 5000 && !m.try_emplace("key7", 0).second && m.at("key7") == 7);
+	bool all = true;
+	for (int i = 0; i < 5000; ++i)all = all && m.find("key" + std::to_string(i))->second == i;
+	CHECK(all && !m.contains("key5000") && m.find("") == m.end());
+
+	// 删除后留下的标记不影响之后的查找与插入
+	for (int i = 0; i < 5000; i += 2)CHECK(m.erase("key" + std::to_string(i)) == 1);
+	CHECK(m.size() == 2500 && !m.contains("key10") && m["key11"] == 11);
+	for (int i = 0; i < 5000; i += 2)m["key" + std::to_string(i)] = -i;
+	CHECK(m.size() == 5000 && m.at("key10") == -10);
+	size_t visited = 0;
+	for (const auto& kv : m)visited += kv.first.compare(0, 3, "key") == 0;
+	CHECK(visited == 5000);
+
+	// 复制、交换与顺序无关的比较
+	map_t c = m, d;
+	CHECK(c == m);
+	c.swap(d);
+	CHECK(c.empty() && d == m);
+	bool thrown = false;
+	try { std::as_const(d).at("missing"); }
+	catch (const std::out_of_range&) { thrown = true; }
+	CHECK(thrown);
+
+	// swiss_json：键的顺序取决于进程的哈希种子（见 _SJSON_HASH_SEED），同一进程内相同的输入得到相同的 dump
+	std::string s = "{";
+	for (int i = 0; i < 200; ++i)s += (i ? ",\"k" : "\"k") + std::to_string(i) + "\":[" + std::to_string(i) + "]";
+	s += "}";
+	swiss_json a = parse_str<swiss_json>(s), b = parse_str<swiss_json>(s);
+	CHECK(a.dump(0) == b.dump(0) && parse_str(a.dump(0)) == parse_str(s));
+	CHECK(a["k123"][0].get<int>() == 123);
+	CHECK(_sjson_detail::hash_seed() == _sjson_detail::hash_seed());
+}
+
+static void demo()
 {
 
 	using sjson::_sjson_detail::parser;
@@ -70,7 +970,38 @@ int main()
 		std::cout << e.what();
 		//MessageBoxA(NULL, e.what(), "e", MB_ICONERROR);
 	}
+}
+
+int main()
+{
+	demo();
 
+	test_contiguous_input();
+	test_structural_index();
+	test_string_scan();
+	test_numbers();
+	test_istream_blocks();
+	test_sax();
+	test_cursor_numbers();
+	test_ndjson();
+	test_parallel();
+	test_push();
+	test_lazy_document();
+	test_in_place();
+	test_string_pool();
+	test_bind();
+	test_projection();
+	test_mapped_file();
+	test_move_construction();
+	test_depth_limit();
+	test_utf8_validation();
+	test_parser_pool();
+	test_raw_numbers();
+	test_compact();
+	test_pmr();
+	test_flat_map();
+	test_swiss_map();
 
-	return 0;
+	std::cout << '\n' << (failures ? "some tests failed" : "all tests passed") << '\n';
+	return failures != 0;
 }
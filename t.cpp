@@ -0,0 +1,7 @@
+#include "sjson.hpp"
+#include <cstdio>
+int main(){
+  std::string s=R"({"a":1,"b":2,"c":3,"d":4,"e":5})";
+  auto j = sjson::parse_projection(std::string_view(s), std::vector<std::string>{"/a","/b","/c","/d","/e"});
+  printf("%s\n", j.dump().c_str());
+}